@@ -0,0 +1,11 @@
+// Copyright 2025 Yxa
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+// The idle thread halts the core on WFI instead of spinning while the main
+// loop blocks, e.g. on a split transaction (serial_dma.c). yxa.c sets
+// DBGMCU DBG_SLEEP so the DWT cycle counter keeps running through it.
+#define CORTEX_ENABLE_WFI_IDLE TRUE
+
+#include_next <chconf.h>
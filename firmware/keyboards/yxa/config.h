@@ -4,14 +4,78 @@
 #pragma once
 
 #define USB_POLLING_INTERVAL_MS 1
+// Release debounce (ms) - presses are reported eagerly, see debounce.c
 #define DEBOUNCE 5
 
-// WS2812 PWM driver configuration
+// Per-key chatter detection: a release and re-press of the same key within
+// the window, with no other press in between, raises that key's release
+// debounce by one step (see debounce.c)
+#define YXA_CHATTER_WINDOW_MS 20
+#define YXA_CHATTER_DEBOUNCE_STEP 5
+#define YXA_CHATTER_DEBOUNCE_MAX 30
+// Replay chatter cases (incl. a re-press one timer wrap later) at init and
+// print the result to the debug console
+// #define YXA_CHATTER_SELFTEST
+
+// Split transactions (yxa.c, split_sync.c, serial_dma.c)
+#define SPLIT_TRANSACTION_IDS_KB YXA_SYNC_CHATTER, YXA_SYNC_DELTA, YXA_SYNC_BENCH, YXA_SYNC_INDICATOR, YXA_SYNC_TUNING
+
+// EEPROM datablock (wear-leveled flash): runtime tuning block (tuning.c),
+// then records of the persistence service (persist.c)
+#define YXA_TUNING_SIZE 16
+#define YXA_PERSIST_SIZE 48
+#define EECONFIG_KB_DATA_SIZE (YXA_TUNING_SIZE + YXA_PERSIST_SIZE)
+// QMK clears the datablock when its version changes, and defaults the
+// version to the size, so growing it would wipe the tuning block. Change
+// this only for a layout that old data can't be read with; 64 is what the
+// default gave boards flashed before it was set.
+#define EECONFIG_KB_DATA_VERSION 64
+
+// Persistence service flushes dirty records in one batch, with no input for
+// YXA_PERSIST_IDLE_MS and at most once per YXA_PERSIST_INTERVAL_MS
+#define YXA_PERSIST_IDLE_MS 3000
+#define YXA_PERSIST_INTERVAL_MS 10000
+
+// Full-duplex DMA transport (YXA_SPLIT_DMA=yes, needs a TRRS cable): TX of
+// each half to RX of the other
+#ifdef YXA_SPLIT_DMA
+#    define SERIAL_USART_FULL_DUPLEX
+#    define SERIAL_USART_TX_PIN A9
+#    define SERIAL_USART_RX_PIN A10
+#endif
+
+// Master polls the other half at most this often; local scans in between
+// don't block on the USART. A quiet poll is one checksum byte (split_sync.c).
+#define YXA_SPLIT_POLL_INTERVAL_US 100
+
+// Split link supervision (split_sync.c): the link is down after this long
+// without a good poll. QMK stops trying after SPLIT_MAX_CONNECTION_ERRORS
+// failed rounds and then retries once per SPLIT_CONNECTION_CHECK_TIMEOUT;
+// a failed round blocks for SERIAL_USART_TIMEOUT, so keep that short.
+#define YXA_SPLIT_LINK_TIMEOUT_MS 30
+#define SPLIT_MAX_CONNECTION_ERRORS 5
+#define SPLIT_CONNECTION_CHECK_TIMEOUT 100
+#define SERIAL_USART_TIMEOUT 5
+
+// Idle power tiers (power.c): dim LEDs, LEDs off, then a slower split link
+// poll (the local scan keeps its rate). USB suspend goes straight to the
+// last tier.
+#define YXA_POWER_DIM_MS 60000
+#define YXA_POWER_OFF_MS 300000
+#define YXA_POWER_SLOW_MS 600000
+#define YXA_POWER_DIM_SCALE 64  // Of 256
+#define YXA_POWER_SLOW_POLL_INTERVAL_US 2000
+
+// WS2812 PWM driver configuration (one-shot DMA, ws2812_dma.c)
+// Estimated LED current for the whole board (both halves share the USB
+// port); brighter frames are scaled down uniformly
+#define YXA_RGB_CURRENT_LIMIT_MA 400
 #define WS2812_PWM_DRIVER PWMD3
 #define WS2812_DMA_STREAM STM32_DMA1_STREAM2
 #define WS2812_DMA_CHANNEL 5
 
-// Mouse key settings - constant speed, no acceleration
+// Mouse key settings - constant speed, no acceleration (the miryoku keymap
+// drives cursor and wheel keys itself, see YXA_MOUSE_* there)
 #define MOUSEKEY_DELAY 0
 #define MOUSEKEY_INTERVAL 16
 #define MOUSEKEY_MOVE_DELTA 3
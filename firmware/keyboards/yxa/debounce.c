@@ -0,0 +1,274 @@
+// Copyright 2025 Yxa
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+// Per-key eager-press / deferred-release debounce.
+//
+// A press is reported on the first scan that sees it. A release is only
+// reported once the key has read released for DEBOUNCE ms in a row, so
+// chatter around either edge never produces a phantom release/press pair.
+// Per-key state is bit-packed into matrix rows; the only per-key bytes are
+// the 8-bit release timestamps.
+//
+// To measure what this buys, a shadow of the global deferred algorithm runs
+// alongside: it would have reported each press only after the whole half
+// was quiet for DEBOUNCE ms. The difference is accumulated as latency saved.
+//
+// Worn switches and loose hot-swap sockets get caught per key: a release
+// followed by a re-press of the same key within YXA_CHATTER_WINDOW_MS, with
+// no other key pressed in between, counts as chatter and raises that key's
+// release debounce by YXA_CHATTER_DEBOUNCE_STEP (up to ..._MAX). Healthy
+// keys stay at DEBOUNCE. Release times for this are 16-bit, and a release
+// older than the window is forgotten on the next scan, so a re-press that
+// comes a whole number of timer wraps later never looks like chatter.
+//
+// YXA_CHATTER_SELFTEST replays a few such cases at init on a synthetic
+// clock and prints the result to the debug console.
+//
+// DEBOUNCE is only the default: the runtime tuning block (tuning.c) can
+// change the base debounce live, chatter steps stay on top of it.
+//
+// The learned debounce and chatter counts survive a replug through the
+// persistence service (persist.c).
+
+#include "quantum.h"
+#include "debounce.h"
+#include "yxa.h"
+
+#if YXA_CHATTER_DEBOUNCE_MAX > UINT8_MAX
+#    error "Chatter debounce must fit the 8-bit per-key release timers"
+#endif
+
+static uint8_t debounce_ms = DEBOUNCE;  // Base release debounce
+static matrix_row_t release_pending[ROWS_PER_HAND];
+static uint8_t release_start[ROWS_PER_HAND][MATRIX_COLS];
+
+// Chatter tracking
+static uint8_t key_debounce[ROWS_PER_HAND][MATRIX_COLS];
+static uint8_t chatter_count[ROWS_PER_HAND][MATRIX_COLS];
+static uint16_t released_at[ROWS_PER_HAND][MATRIX_COLS];
+static uint8_t release_seq[ROWS_PER_HAND][MATRIX_COLS];
+static matrix_row_t recently_released[ROWS_PER_HAND];
+static uint8_t press_seq = 0;  // Bumped on every press, to spot activity in between
+
+// Shadow of the global deferred algorithm, for latency accounting
+static matrix_row_t shadow_pending[ROWS_PER_HAND];
+static uint32_t press_cycles[ROWS_PER_HAND][MATRIX_COLS];
+static uint16_t last_raw_change = 0;
+static yxa_debounce_stats_t debounce_stats;
+
+static void check_chatter(uint8_t row, uint8_t col, uint16_t now) {
+    matrix_row_t mask = (matrix_row_t)1 << col;
+    if (!(recently_released[row] & mask)) {
+        return;
+    }
+    recently_released[row] &= ~mask;
+
+    if (release_seq[row][col] != press_seq || TIMER_DIFF_16(now, released_at[row][col]) >= YXA_CHATTER_WINDOW_MS) {
+        return;
+    }
+
+    if (chatter_count[row][col] < UINT8_MAX) {
+        chatter_count[row][col]++;
+    }
+    key_debounce[row][col] = MIN(key_debounce[row][col] + YXA_CHATTER_DEBOUNCE_STEP, YXA_CHATTER_DEBOUNCE_MAX);
+    yxa_persist_dirty(YXA_PERSIST_CHATTER_DEBOUNCE);
+    yxa_persist_dirty(YXA_PERSIST_CHATTER_COUNTS);
+}
+
+// Forget releases that are past the chatter window
+static void expire_releases(uint8_t num_rows, uint16_t now) {
+    for (uint8_t row = 0; row < num_rows; row++) {
+        matrix_row_t recent = recently_released[row];
+        for (uint8_t col = 0; recent; col++, recent >>= 1) {
+            if ((recent & 1) && TIMER_DIFF_16(now, released_at[row][col]) >= YXA_CHATTER_WINDOW_MS) {
+                recently_released[row] &= ~((matrix_row_t)1 << col);
+            }
+        }
+    }
+}
+
+static void shadow_settle(uint8_t num_rows, uint16_t timer) {
+    if (TIMER_DIFF_16(timer, last_raw_change) < debounce_ms) {
+        return;
+    }
+
+    uint32_t now = yxa_cycles();
+    for (uint8_t row = 0; row < num_rows; row++) {
+        matrix_row_t pending = shadow_pending[row];
+        for (uint8_t col = 0; pending; col++, pending >>= 1) {
+            if (!(pending & 1)) {
+                continue;
+            }
+            uint32_t saved_us = (now - press_cycles[row][col]) / YXA_CYCLES_PER_US;
+            debounce_stats.presses++;
+            debounce_stats.saved_us_total += saved_us;
+            if (saved_us > debounce_stats.saved_us_max) {
+                debounce_stats.saved_us_max = MIN(saved_us, UINT16_MAX);
+            }
+        }
+        shadow_pending[row] = 0;
+    }
+}
+
+static bool debounce_at(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, bool changed, uint16_t now16) {
+    bool cooked_changed = false;
+    uint8_t now = now16 & 0xFF;  // Release timers only span the debounce
+
+    if (changed) {
+        last_raw_change = now16;
+    }
+    expire_releases(num_rows, now16);
+
+    for (uint8_t row = 0; row < num_rows; row++) {
+        matrix_row_t delta = raw[row] ^ cooked[row];
+
+        // Key reads pressed again: any release in progress was chatter
+        release_pending[row] &= delta;
+
+        if (!delta) {
+            continue;
+        }
+
+        // Eager press: report immediately
+        matrix_row_t pressed = delta & raw[row];
+        if (pressed) {
+            cooked[row] |= pressed;
+            shadow_pending[row] |= pressed;
+            for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+                if (pressed & ((matrix_row_t)1 << col)) {
+                    press_cycles[row][col] = yxa_cycles();
+                    check_chatter(row, col, now16);
+                    press_seq++;
+                }
+            }
+            cooked_changed = true;
+        }
+
+        // Deferred release: start the timer, report once it runs out
+        matrix_row_t released = delta & ~raw[row];
+        for (uint8_t col = 0; released; col++, released >>= 1) {
+            if (!(released & 1)) {
+                continue;
+            }
+            matrix_row_t mask = (matrix_row_t)1 << col;
+            if (!(release_pending[row] & mask)) {
+                release_pending[row] |= mask;
+                release_start[row][col] = now;
+            } else if ((uint8_t)(now - release_start[row][col]) >= key_debounce[row][col]) {
+                release_pending[row] &= ~mask;
+                cooked[row] &= ~mask;
+                recently_released[row] |= mask;
+                released_at[row][col] = now16;
+                release_seq[row][col] = press_seq;
+                cooked_changed = true;
+            }
+        }
+    }
+
+    shadow_settle(num_rows, now16);
+    return cooked_changed;
+}
+
+bool debounce(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, bool changed) {
+    return debounce_at(raw, cooked, num_rows, changed, timer_read());
+}
+
+#ifdef YXA_CHATTER_SELFTEST
+// Key (0, 0): press at t, release, re-press `gap` ms after the release
+// completes, one scan per ms in between. Returns whether it counted as
+// chatter.
+static bool chatter_replay(uint16_t t, uint16_t gap) {
+    matrix_row_t raw[ROWS_PER_HAND] = {0};
+    matrix_row_t cooked[ROWS_PER_HAND] = {0};
+    uint8_t before = chatter_count[0][0];
+
+    raw[0] = 1;
+    debounce_at(raw, cooked, ROWS_PER_HAND, true, t);
+    raw[0] = 0;
+    debounce_at(raw, cooked, ROWS_PER_HAND, true, ++t);
+    while (cooked[0]) {
+        debounce_at(raw, cooked, ROWS_PER_HAND, false, ++t);
+    }
+    for (uint16_t i = 1; i < gap; i++) {
+        debounce_at(raw, cooked, ROWS_PER_HAND, false, ++t);
+    }
+    raw[0] = 1;
+    debounce_at(raw, cooked, ROWS_PER_HAND, true, ++t);
+    raw[0] = 0;
+    while (cooked[0]) {
+        debounce_at(raw, cooked, ROWS_PER_HAND, true, ++t);
+    }
+    return chatter_count[0][0] != before;
+}
+
+static void chatter_selftest(void) {
+    bool ok = chatter_replay(1000, YXA_CHATTER_WINDOW_MS / 2);  // Real chatter
+    ok &= !chatter_replay(2000, 256);                            // 8-bit wrap
+    ok &= !chatter_replay(3000, 512 + YXA_CHATTER_WINDOW_MS / 2);
+    ok &= !chatter_replay(0xFFF0, 256);                          // 16-bit wrap too
+    dprintf("yxa chatter selftest: %s\n", ok ? "ok" : "FAILED");
+}
+#endif
+
+static void debounce_state_clear(void) {
+    memset(release_pending, 0, sizeof(release_pending));
+    memset(shadow_pending, 0, sizeof(shadow_pending));
+    memset(recently_released, 0, sizeof(recently_released));
+    yxa_chatter_reset();
+}
+
+void debounce_init(uint8_t num_rows) {
+#ifdef YXA_CHATTER_SELFTEST
+    debounce_state_clear();
+    chatter_selftest();
+    memset(&debounce_stats, 0, sizeof(debounce_stats));
+#endif
+    debounce_state_clear();
+}
+
+void debounce_free(void) {}
+
+void yxa_chatter_read(uint8_t kind, uint8_t *out) {
+    const uint8_t *src = kind == YXA_CHATTER_DEBOUNCE ? &key_debounce[0][0] : &chatter_count[0][0];
+    memcpy(out, src, YXA_CHATTER_KEYS);
+}
+
+void yxa_chatter_reset(void) {
+    memset(key_debounce, debounce_ms, sizeof(key_debounce));
+    memset(chatter_count, 0, sizeof(chatter_count));
+    yxa_persist_dirty(YXA_PERSIST_CHATTER_DEBOUNCE);
+    yxa_persist_dirty(YXA_PERSIST_CHATTER_COUNTS);
+}
+
+// After the tuning block has set the base: stored values below it (saved
+// under a lower base) are raised to it
+void yxa_chatter_persist_init(void) {
+    yxa_persist_register(YXA_PERSIST_CHATTER_COUNTS, YXA_PERSIST_CHATTER_COUNTS_OFFSET, chatter_count, sizeof(chatter_count));
+    if (yxa_persist_register(YXA_PERSIST_CHATTER_DEBOUNCE, YXA_PERSIST_CHATTER_DEBOUNCE_OFFSET, key_debounce, sizeof(key_debounce))) {
+        for (uint8_t row = 0; row < ROWS_PER_HAND; row++) {
+            for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+                key_debounce[row][col] = MIN(MAX(key_debounce[row][col], debounce_ms), YXA_CHATTER_DEBOUNCE_MAX);
+            }
+        }
+    }
+}
+
+// Keys keep the chatter steps they earned on top of the new base
+void yxa_debounce_set(uint8_t ms) {
+    for (uint8_t row = 0; row < ROWS_PER_HAND; row++) {
+        for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+            uint8_t extra = key_debounce[row][col] - debounce_ms;
+            key_debounce[row][col] = MIN(ms + extra, YXA_CHATTER_DEBOUNCE_MAX);
+        }
+    }
+    debounce_ms = ms;
+    yxa_persist_dirty(YXA_PERSIST_CHATTER_DEBOUNCE);
+}
+
+void yxa_debounce_stats_get(yxa_debounce_stats_t *stats) {
+    *stats = debounce_stats;
+}
+
+void yxa_debounce_stats_reset(void) {
+    memset(&debounce_stats, 0, sizeof(debounce_stats));
+}
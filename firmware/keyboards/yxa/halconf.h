@@ -7,4 +7,12 @@
 #define SERIAL_USB_BUFFERS_SIZE 256
 #define HAL_USE_SERIAL TRUE
 
+// Full-duplex DMA split transport (serial_dma.c)
+#ifdef YXA_SPLIT_DMA
+#    define HAL_USE_UART TRUE
+#endif
+
+// EXTI wake-up for idle matrix sleep (matrix.c)
+#define PAL_USE_CALLBACKS TRUE
+
 #include_next <halconf.h>
@@ -24,6 +24,10 @@
 // Per-key tapping term: uses get_tapping_term() in yxa_features.c
 #define TAPPING_TERM_PER_KEY
 
+// These terms and QUICK_TAP_TERM are defaults: the runtime tuning block
+// (MSG_TUNING over raw HID) overrides them without a reflash
+#define QUICK_TAP_TERM_PER_KEY
+
 // QUICK_TAP_TERM: Double-tap within this time = always tap (good for "ff", "ss")
 #define QUICK_TAP_TERM 120
 
@@ -45,6 +49,25 @@
 // key, send the tap keycode on release. Can be useful but also causes misfires.
 // #define RETRO_TAPPING
 
+// ROLL GUARD: A mod-tap pressed less than this long after the previous key
+// press on the same hand can't become a hold - it's settled as a tap as soon
+// as the next key goes down. Stops "st"/"ts" rolls turning into Ctrl/Shift
+// under permissive hold. Per-position terms come from get_roll_guard_term()
+// in yxa_features.c.
+#define YXA_ROLL_GUARD_TERM 150
+#define YXA_ROLL_GUARD_SHIFT_TERM 100
+
+// SPECULATIVE HOLD: Register Shift/Ctrl home-row mods on press so mod+click
+// and mod+scroll with a real mouse work without waiting for the tapping term.
+// Retracted with a cancel report if the key turns out to be a tap.
+// GUI and Alt are always excluded - they trigger OS actions on their own.
+#define YXA_SPECULATIVE_HOLD
+#define YXA_SPECULATIVE_HOLD_MODS (MOD_MASK_CS)
+
+// Record how long key events sit in the tap-hold buffer and how deep it gets
+// (histograms readable over raw HID, MSG_TAPHOLD_STATS)
+#define YXA_TAPHOLD_STATS
+
 // IGNORE_MOD_TAP_INTERRUPT: Deprecated in favor of HOLD_ON_OTHER_KEY_PRESS
 // Don't use this.
 
@@ -52,8 +75,63 @@
 // RGB Layer Indication
 // ============================================================================
 
-// Full brightness for layer colors (0-255)
+// Full brightness for layer colors (0-255), default for the tuning block
 #define RGB_LAYER_BRIGHTNESS 255
 
 // Dim brightness for TAP layer indicator (0-255)
 #define RGB_TAP_BRIGHTNESS 100
+
+// Keypress heatmap effect (select with RGB_MOD; shown on the BASE layer):
+// heat added per press (8.8 fixed point), decayed by 1/2^SHIFT every
+// DECAY_MS, and the brightness of a cold key
+#define YXA_HEATMAP_PRESS_HEAT 0x2000
+#define YXA_HEATMAP_DECAY_MS 100
+#define YXA_HEATMAP_DECAY_SHIFT 5
+#define YXA_HEATMAP_MIN_BRIGHTNESS 16
+
+// Layer change animation: each LED fades over FADE_MS, starting as a ripple
+// from the layer's thumb key reaches it (RIPPLE_MS to cross the board).
+// Animation frames costing more than ANIM_BUDGET_US make the next one drop.
+#define YXA_RGB_FADE_MS 150
+#define YXA_RGB_RIPPLE_MS 200
+#define YXA_RGB_ANIM_BUDGET_US 100
+
+// ============================================================================
+// Kinetic Mouse Keys
+// ============================================================================
+
+// Cursor keys run on the engine in yxa_features.c instead of QMK's constant
+// speed: the cursor starts at START px/s, reaches MAX px/s after TIME_TO_MAX
+// ms held, and on release coasts, keeping FRICTION/256 of its speed every
+// tick (0 stops dead). A report goes out every YXA_MOUSE_INTERVAL_MS.
+// The profile is chosen over raw HID (MSG_MOUSE_PROFILE); KC_ACL0-2, where
+// mapped, switch to PRECISE/NORMAL/FAST while held.
+#define YXA_MOUSE_INTERVAL_MS 4
+#define YXA_MOUSE_PRECISE_START 30
+#define YXA_MOUSE_PRECISE_MAX 300
+#define YXA_MOUSE_PRECISE_TIME_TO_MAX 400
+#define YXA_MOUSE_PRECISE_FRICTION 0
+#define YXA_MOUSE_NORMAL_START 120
+#define YXA_MOUSE_NORMAL_MAX 1600
+#define YXA_MOUSE_NORMAL_TIME_TO_MAX 600
+#define YXA_MOUSE_NORMAL_FRICTION 192
+#define YXA_MOUSE_FAST_START 300
+#define YXA_MOUSE_FAST_MAX 3000
+#define YXA_MOUSE_FAST_TIME_TO_MAX 300
+#define YXA_MOUSE_FAST_FRICTION 224
+
+// Wheel keys, same engine, in detents/s. The wheel ticks on every
+// (INTERVAL / YXA_MOUSE_INTERVAL_MS)th cursor tick, so keep it a multiple.
+// Hi-res wheel is opt-in: with POINTING_DEVICE_HIRES_SCROLL_ENABLE, QMK puts
+// the HID resolution multiplier in the mouse descriptor (it needs only
+// mouse keys, not POINTING_DEVICE_ENABLE) and each detent is sent as
+// MULTIPLIER smaller steps. A host that ignores the multiplier (macOS)
+// then scrolls MULTIPLIER times faster, and the board can't tell, so it
+// stays off by default.
+// #define POINTING_DEVICE_HIRES_SCROLL_ENABLE
+#define POINTING_DEVICE_HIRES_SCROLL_MULTIPLIER 8
+#define YXA_MOUSE_WHEEL_INTERVAL_MS 12
+#define YXA_MOUSE_WHEEL_START 6
+#define YXA_MOUSE_WHEEL_MAX 40
+#define YXA_MOUSE_WHEEL_TIME_TO_MAX 1000
+#define YXA_MOUSE_WHEEL_FRICTION 0
@@ -15,3 +15,5 @@ KEY_OVERRIDE_ENABLE = yes
 
 # Custom features
 SRC += yxa_features.c
+# Keypress heatmap effect (rgb_matrix_user.inc)
+RGB_MATRIX_CUSTOM_USER = yes
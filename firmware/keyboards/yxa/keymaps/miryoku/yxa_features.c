@@ -3,6 +3,7 @@
 
 #include QMK_KEYBOARD_H
 #include "raw_hid.h"
+#include "yxa.h"
 
 // Message types for HID protocol
 #define MSG_REQUEST_STATE   0x00  // Host -> Keyboard: Request full state
@@ -14,6 +15,15 @@
 #define MSG_HEARTBEAT       0x06  // Host -> Keyboard: Connection check
 #define MSG_FULL_STATE      0x07  // Keyboard -> Host: Full state response
 #define MSG_KEY_BATCH       0x08  // Keyboard -> Host: Batched key events
+#define MSG_TAPHOLD_STATS   0x09  // Host <-> Keyboard: Tap-hold buffer histograms
+#define MSG_SCAN_STATS      0x0A  // Host <-> Keyboard: Matrix scan rate and cost
+#define MSG_CHATTER_STATS   0x0B  // Host <-> Keyboard: Per-key chatter counts/debounce
+#define MSG_SPLIT_STATS     0x0C  // Host <-> Keyboard: Split link polling and deltas
+#define MSG_SPLIT_BENCH     0x0D  // Host <-> Keyboard: Split link round trip per baud rate
+#define MSG_RGB_STATS       0x0E  // Host <-> Keyboard: WS2812 flushes and skips
+#define MSG_MOUSE_PROFILE   0x0F  // Host <-> Keyboard: Mouse key profile select/read
+#define MSG_TUNING          0x11  // Host <-> Keyboard: Runtime tuning block read/write
+#define MSG_PERSIST_STATS   0x12  // Host <-> Keyboard: EEPROM persistence writes
 
 #ifndef RAW_EPSIZE
 #define RAW_EPSIZE 32
@@ -36,6 +46,19 @@ static uint16_t last_batch_time = 0;
 static uint8_t pressed_keys[MAX_PRESSED_KEYS][2];  // row, col pairs
 static uint8_t pressed_key_count = 0;
 
+// Keypress heatmap and hold overlay upkeep (defined in RGB section below)
+static void heatmap_task(void);
+static void overlay_pending_press(uint16_t keycode, keyrecord_t *record);
+static void overlay_pending_resolve(keyrecord_t *record);
+static void overlay_update(void);
+static void anim_stats_put(uint8_t *out, bool reset);
+
+// Kinetic mouse keys (defined in mouse section below)
+static bool mouse_keys_process(uint16_t keycode, keyrecord_t *record);
+static void mouse_keys_task(void);
+static void mouse_profile_send(uint8_t *data);
+static bool mouse_tuning_valid(const yxa_tuning_t *tuning);
+
 // Get effective layer (combines default layer with momentary layers)
 static uint8_t get_effective_layer(void) {
     layer_state_t effective = layer_state | default_layer_state;
@@ -141,6 +164,227 @@ static void send_full_state(void) {
     // Note: We don't track pressed keys in firmware, so count is 0
     // The visual guide tracks this from press/release events
     response[4] = 0;  // pressed key count
+    response[5] = get_highest_layer(default_layer_state);
+    response[6] = yxa_persist_pending(YXA_PERSIST_DEFAULT_LAYER) ? 1 : 0;
+    raw_hid_send(response, RAW_EPSIZE);
+}
+
+// Default layer chosen with the tap dances (BASE/EXTRA/TAP) survives a
+// replug. It is a record of the persistence service (persist.c), which
+// writes it in an idle-time batch, so flipping between modes costs a
+// single write of the final choice (none if it ends where it started),
+// and never one mid-typing.
+static uint8_t default_layer_persisted = 0;
+
+layer_state_t default_layer_state_set_user(layer_state_t state) {
+    uint8_t layer = get_highest_layer(state);
+    if (layer != default_layer_persisted) {
+        default_layer_persisted = layer;
+        yxa_persist_dirty(YXA_PERSIST_DEFAULT_LAYER);
+    }
+    return state;
+}
+
+// Runs before the first matrix scan
+void keyboard_post_init_user(void) {
+    if (yxa_persist_register(YXA_PERSIST_DEFAULT_LAYER, YXA_PERSIST_DEFAULT_LAYER_OFFSET, &default_layer_persisted, sizeof(default_layer_persisted))) {
+        default_layer_set((layer_state_t)1 << default_layer_persisted);
+    }
+}
+
+// Little-endian helpers for multi-byte response fields
+static inline void put_u16(uint8_t *buf, uint16_t value) {
+    buf[0] = value & 0xFF;
+    buf[1] = value >> 8;
+}
+
+static inline void put_u32(uint8_t *buf, uint32_t value) {
+    put_u16(buf, value & 0xFFFF);
+    put_u16(buf + 2, value >> 16);
+}
+
+// Matrix scan and debounce statistics (master half)
+// Response: [1..4] scans/s, [5..6] avg read cycles, [7..8] max read cycles,
+// [9] cycles per microsecond, [10..13] presses measured, [14..15] avg and
+// [16..17] max press latency saved by eager debounce (us)
+static void send_scan_stats(uint8_t *data) {
+    yxa_scan_stats_t stats;
+    yxa_scan_stats_get(&stats);
+    yxa_debounce_stats_t debounce;
+    yxa_debounce_stats_get(&debounce);
+    uint16_t saved_avg = debounce.presses ? debounce.saved_us_total / debounce.presses : 0;
+
+    uint8_t response[RAW_EPSIZE] = {0};
+    response[0] = MSG_SCAN_STATS;
+    put_u32(&response[1], stats.scan_rate);
+    put_u16(&response[5], stats.read_cycles_avg);
+    put_u16(&response[7], stats.read_cycles_max);
+    response[9] = YXA_CYCLES_PER_US;
+    put_u32(&response[10], debounce.presses);
+    put_u16(&response[14], saved_avg);
+    put_u16(&response[16], debounce.saved_us_max);
+    raw_hid_send(response, RAW_EPSIZE);
+
+    if (data[1] == 1) {
+        yxa_scan_stats_reset();
+        yxa_debounce_stats_reset();
+    }
+}
+
+// Per-key chatter data for one half
+// Request: [1] half (0 = left, 1 = right), [2] kind (counts/debounce/reset)
+// Response: [1] half, [2] kind, [3] ok, [4..23] one byte per key, row-major
+static void send_chatter_stats(uint8_t *data) {
+    uint8_t response[RAW_EPSIZE] = {0};
+    response[0] = MSG_CHATTER_STATS;
+    response[1] = data[1];
+    response[2] = data[2];
+    response[3] = yxa_chatter_request(data[1] == 0, data[2], &response[4]) ? 1 : 0;
+    raw_hid_send(response, RAW_EPSIZE);
+}
+
+// Split link statistics (master)
+// Response: [1..2] polls/s, [3..4] avg and [5..6] max cycles per poll,
+// [7..10] delta events applied, [11..14] full-matrix refreshes,
+// [15] cycles per microsecond, [16..19] failed polls, [20..21] link losses,
+// [22..23] last and [24..25] longest outage before reconnect (ms)
+static void send_split_stats(uint8_t *data) {
+    yxa_split_stats_t stats;
+    yxa_split_stats_get(&stats);
+
+    uint8_t response[RAW_EPSIZE] = {0};
+    response[0] = MSG_SPLIT_STATS;
+    put_u16(&response[1], stats.poll_rate);
+    put_u16(&response[3], stats.transport_cycles_avg);
+    put_u16(&response[5], stats.transport_cycles_max);
+    put_u32(&response[7], stats.delta_events);
+    put_u32(&response[11], stats.full_refreshes);
+    response[15] = YXA_CYCLES_PER_US;
+    put_u32(&response[16], stats.failed_polls);
+    put_u16(&response[20], stats.link_losses);
+    put_u16(&response[22], stats.recovery_ms_last);
+    put_u16(&response[24], stats.recovery_ms_max);
+    raw_hid_send(response, RAW_EPSIZE);
+
+    if (data[1] == 1) {
+        yxa_split_stats_reset();
+    }
+}
+
+// Split link benchmark (full-duplex DMA transport only, blocks ~100 ms)
+// Response: [1] rate count (0 without the DMA transport), then 7 bytes per
+// rate from [2]: speed / 100 (2), avg (2) and max (2) round trip in us,
+// failed transactions (1, 255 if the rate couldn't be set up)
+static void send_split_bench(void) {
+    uint8_t response[RAW_EPSIZE] = {0};
+    response[0] = MSG_SPLIT_BENCH;
+#ifdef YXA_SPLIT_DMA
+    yxa_split_bench_t results[YXA_SPLIT_BENCH_RATES];
+    yxa_split_bench(results);
+
+    response[1] = YXA_SPLIT_BENCH_RATES;
+    for (uint8_t i = 0; i < YXA_SPLIT_BENCH_RATES; i++) {
+        uint8_t *out = &response[2 + i * 7];
+        put_u16(&out[0], results[i].speed / 100);
+        put_u16(&out[2], results[i].rtt_us_avg);
+        put_u16(&out[4], results[i].rtt_us_max);
+        out[6] = results[i].errors;
+    }
+#endif
+    raw_hid_send(response, RAW_EPSIZE);
+}
+
+// WS2812 flush statistics (master half)
+// Response: [1..4] flush calls, [5..8] DMA transfers, [9..12] skipped as
+// unchanged, [13..16] skipped while the previous transfer ran, [17..20]
+// frames scaled to the current limit, [21..22] last and [23..24] highest
+// estimated frame draw (mA, this half, before scaling), [25..26] layer
+// animation frames drawn, [27..28] dropped over budget, [29..30] longest
+// animation frame render (us)
+static void send_rgb_stats(uint8_t *data) {
+    yxa_rgb_stats_t stats;
+    yxa_rgb_stats_get(&stats);
+
+    uint8_t response[RAW_EPSIZE] = {0};
+    response[0] = MSG_RGB_STATS;
+    put_u32(&response[1], stats.flush_calls);
+    put_u32(&response[5], stats.transfers);
+    put_u32(&response[9], stats.skipped_clean);
+    put_u32(&response[13], stats.skipped_busy);
+    put_u32(&response[17], stats.scaled_frames);
+    put_u16(&response[21], stats.frame_ma_last);
+    put_u16(&response[23], stats.frame_ma_max);
+    anim_stats_put(&response[25], data[1] == 1);
+    raw_hid_send(response, RAW_EPSIZE);
+
+    if (data[1] == 1) {
+        yxa_rgb_stats_reset();
+    }
+}
+
+// EEPROM persistence service statistics (master half)
+// Response: [1..4] batches flushed, [5..8] records and [9..12] bytes
+// written, [13..14] last and [15..16] longest flush stall (us), [17]
+// records waiting, [18] bytes of the record area in use, [19] its size
+static void send_persist_stats(uint8_t *data) {
+    yxa_persist_stats_t stats;
+    yxa_persist_stats_get(&stats);
+
+    uint8_t response[RAW_EPSIZE] = {0};
+    response[0] = MSG_PERSIST_STATS;
+    put_u32(&response[1], stats.flushes);
+    put_u32(&response[5], stats.records_written);
+    put_u32(&response[9], stats.bytes_written);
+    put_u16(&response[13], stats.flush_us_last);
+    put_u16(&response[15], stats.flush_us_max);
+    response[17] = stats.dirty_records;
+    response[18] = stats.bytes_used;
+    response[19] = YXA_PERSIST_SIZE;
+    raw_hid_send(response, RAW_EPSIZE);
+
+    if (data[1] == 1) {
+        yxa_persist_stats_reset();
+    }
+}
+
+// Runtime tuning block (yxa_tuning_t in yxa.h), saved and synced to the
+// slave by the keyboard
+// Request: [1] op (0 read, 1 write, 2 restore defaults), [2..17] block to
+// write
+// Response: [1] op, [2] ok, [3..18] block in effect
+enum { TUNING_READ = 0, TUNING_WRITE, TUNING_DEFAULTS };
+
+#define TUNING_TERM_MIN 50
+#define TUNING_TERM_MAX 1000
+
+// Checked by the keyboard for every block it takes: host writes, the
+// master's pushes and what it loads from EEPROM
+bool yxa_tuning_valid_user(const yxa_tuning_t *tuning) {
+    const uint16_t terms[] = {tuning->tapping_term, tuning->tapping_term_mod_tap, tuning->tapping_term_layer};
+    for (uint8_t i = 0; i < ARRAY_SIZE(terms); i++) {
+        if (terms[i] < TUNING_TERM_MIN || terms[i] > TUNING_TERM_MAX) {
+            return false;
+        }
+    }
+    return tuning->quick_tap_term <= TUNING_TERM_MAX && mouse_tuning_valid(tuning);
+}
+
+static void send_tuning(uint8_t *data) {
+    yxa_tuning_t tuning;
+    bool ok = true;
+    if (data[1] == TUNING_WRITE) {
+        memcpy(&tuning, &data[2], sizeof(tuning));
+        ok = yxa_tuning_set(&tuning);
+    } else if (data[1] == TUNING_DEFAULTS) {
+        yxa_tuning_defaults(&tuning);
+        ok = yxa_tuning_set(&tuning);
+    }
+
+    uint8_t response[RAW_EPSIZE] = {0};
+    response[0] = MSG_TUNING;
+    response[1] = data[1];
+    response[2] = ok ? 1 : 0;
+    memcpy(&response[3], yxa_tuning(), sizeof(yxa_tuning_t));
     raw_hid_send(response, RAW_EPSIZE);
 }
 
@@ -180,28 +424,78 @@ void housekeeping_task_user(void) {
         data[1] = current_mods;
         raw_hid_send(data, RAW_EPSIZE);
     }
+
+    // Indicator state for both halves' LEDs, synced to the slave on change
+    if (is_keyboard_master()) {
+        uint8_t mode = YXA_RENDER_LAYER;
+#ifdef RGB_MATRIX_ENABLE
+        if (rgb_matrix_get_mode() == RGB_MATRIX_CUSTOM_YXA_HEATMAP) {
+            mode = YXA_RENDER_HEATMAP;
+        }
+#endif
+        yxa_indicator_set(current_layer | (current_caps_word ? YXA_INDICATOR_CAPS_WORD : 0) | (mode << YXA_INDICATOR_MODE_SHIFT));
+        overlay_update();
+    }
+
+    heatmap_task();
+    mouse_keys_task();
 }
 
 // Bilateral combination tracking (declared in tap-hold section below)
 extern bool last_key_left_hand;
 extern bool has_pending_key;
 
+// Tap-hold hooks (defined in tap-hold section below)
+static void speculative_hold_press(uint16_t keycode, keyrecord_t *record);
+static void speculative_hold_resolve(uint16_t keycode, keyrecord_t *record);
+static void taphold_stats_enqueue(keyrecord_t *record);
+static void taphold_stats_dequeue(keyrecord_t *record);
+static void taphold_stats_send(uint8_t *data);
+static bool roll_guard_process(uint16_t keycode, keyrecord_t *record);
+static void roll_guard_resolve(keyrecord_t *record);
+
+// Set by roll_guard_process when the key just pressed may not become a hold
+static bool roll_guard_current = false;
+
+// Raw key events, before action_tapping gets to buffer them
+bool pre_process_record_user(uint16_t keycode, keyrecord_t *record) {
+    if (!roll_guard_process(keycode, record)) {
+        return false;
+    }
+    taphold_stats_enqueue(record);
+    if (record->event.pressed && !roll_guard_current) {
+        speculative_hold_press(keycode, record);
+    }
+    if (record->event.pressed) {
+        overlay_pending_press(keycode, record);
+    }
+    return true;
+}
+
 // Keypress broadcast with batching
 bool process_record_user(uint16_t keycode, keyrecord_t *record) {
     uint8_t type = record->event.pressed ? MSG_KEY_PRESS : MSG_KEY_RELEASE;
     uint8_t row = record->event.key.row;
     uint8_t col = record->event.key.col;
 
+    // Event left the tap-hold buffer (or never entered it)
+    taphold_stats_dequeue(record);
+    overlay_pending_resolve(record);
+
     // Add to batch for efficient transmission
     add_event_to_batch(type, row, col);
 
+    // Tap-hold key resolved: drop speculative mods if it became a tap
+    speculative_hold_resolve(keycode, record);
+    roll_guard_resolve(record);
+
     // Track key hand for bilateral combinations
     if (record->event.pressed) {
         last_key_left_hand = (row < 4);  // Left hand: rows 0-3
         has_pending_key = true;
     }
 
-    return true;
+    return mouse_keys_process(keycode, record);
 }
 
 // Post-process hook - catches any events that might be delayed by tap-hold processing
@@ -229,6 +523,47 @@ bool raw_hid_receive_kb(uint8_t *data, uint8_t length) {
             send_full_state();
             return true;
 
+        case MSG_TAPHOLD_STATS:
+            // data[1]: 0 = read, 1 = read and reset
+            taphold_stats_send(data);
+            return true;
+
+        case MSG_SCAN_STATS:
+            // data[1]: 0 = read, 1 = read and reset
+            send_scan_stats(data);
+            return true;
+
+        case MSG_CHATTER_STATS:
+            send_chatter_stats(data);
+            return true;
+
+        case MSG_SPLIT_STATS:
+            // data[1]: 0 = read, 1 = read and reset
+            send_split_stats(data);
+            return true;
+
+        case MSG_SPLIT_BENCH:
+            send_split_bench();
+            return true;
+
+        case MSG_RGB_STATS:
+            // data[1]: 0 = read, 1 = read and reset
+            send_rgb_stats(data);
+            return true;
+
+        case MSG_MOUSE_PROFILE:
+            mouse_profile_send(data);
+            return true;
+
+        case MSG_TUNING:
+            send_tuning(data);
+            return true;
+
+        case MSG_PERSIST_STATS:
+            // data[1]: 0 = read, 1 = read and reset
+            send_persist_stats(data);
+            return true;
+
         default:
             break;
     }
@@ -249,6 +584,16 @@ static bool is_layer_tap(uint16_t keycode) {
     return (keycode >= QK_LAYER_TAP && keycode <= QK_LAYER_TAP_MAX);
 }
 
+// Mod-tap keycodes store mods in 5-bit form (bit 4 = right hand)
+static uint8_t mod_tap_mods(uint16_t keycode) {
+    uint8_t mods = QK_MOD_TAP_GET_MODS(keycode);
+    return (mods & 0x10) ? (uint8_t)((mods & 0x0F) << 4) : mods;
+}
+
+static bool same_key(keypos_t a, keypos_t b) {
+    return a.row == b.row && a.col == b.col;
+}
+
 // Check which hand a key is on (for bilateral combinations)
 // Left hand: rows 0-3, Right hand: rows 4-7
 static bool is_left_hand(keyrecord_t *record) {
@@ -259,15 +604,19 @@ static bool is_left_hand(keyrecord_t *record) {
 bool last_key_left_hand = false;
 bool has_pending_key = false;
 
-// Per-key tapping term (configured in config.h)
+// Per-key tapping term (defaults in config.h, tuned at runtime over raw HID)
 uint16_t get_tapping_term(uint16_t keycode, keyrecord_t *record) {
     if (is_mod_tap(keycode)) {
-        return TAPPING_TERM_MOD_TAP;
+        return yxa_tuning()->tapping_term_mod_tap;
     }
     if (is_layer_tap(keycode)) {
-        return TAPPING_TERM_LAYER;
+        return yxa_tuning()->tapping_term_layer;
     }
-    return TAPPING_TERM;
+    return yxa_tuning()->tapping_term;
+}
+
+uint16_t get_quick_tap_term(uint16_t keycode, keyrecord_t *record) {
+    return yxa_tuning()->quick_tap_term;
 }
 
 // Per-key permissive hold
@@ -307,6 +656,579 @@ bool get_hold_on_other_key_press(uint16_t keycode, keyrecord_t *record) {
     return false;
 }
 
+// Same-hand roll guard: a mod-tap pressed mid-streak (less than its guard
+// term after the previous press, on the same hand) may not become a hold.
+// If it is still undecided when the next key goes down it is settled as a
+// tap right there, by feeding action_tapping a release ahead of the new
+// press; the physical release is swallowed later. Several keys of a long
+// overlapping roll can be waiting for that at once, so they're tracked
+// per key. A deliberate hold past the tapping term with no other key still
+// becomes a hold.
+
+// Per-position roll guard term (ms), 0 disables the guard for that key
+uint16_t get_roll_guard_term(uint16_t keycode, keyrecord_t *record) {
+    if (!is_mod_tap(keycode)) {
+        return 0;
+    }
+    // Shift is needed mid-sentence for capitals, so it gets a shorter window
+    if (mod_tap_mods(keycode) & MOD_MASK_SHIFT) {
+        return YXA_ROLL_GUARD_SHIFT_TERM;
+    }
+    return YXA_ROLL_GUARD_TERM;
+}
+
+static bool roll_guard_pending = false;                 // Guarded mod-tap still undecided
+static keypos_t roll_guard_key;
+static matrix_row_t roll_guard_swallow[MATRIX_ROWS];    // Physical releases still to drop
+static bool roll_guard_synthesizing = false;
+static bool has_last_press = false;
+static bool last_press_left = false;
+static uint16_t last_press_time = 0;
+
+// Returns false for events that must not reach action_tapping
+static bool roll_guard_process(uint16_t keycode, keyrecord_t *record) {
+    if (roll_guard_synthesizing) {
+        return true;
+    }
+
+    keypos_t key = record->event.key;
+    if (!record->event.pressed) {
+        matrix_row_t mask = (matrix_row_t)1 << key.col;
+        if (key.row < MATRIX_ROWS && (roll_guard_swallow[key.row] & mask)) {
+            roll_guard_swallow[key.row] &= ~mask;
+            return false;
+        }
+        return true;
+    }
+
+    // Settle the pending guarded key as a tap before this press is seen
+    if (roll_guard_pending) {
+        roll_guard_pending = false;
+        roll_guard_swallow[roll_guard_key.row] |= (matrix_row_t)1 << roll_guard_key.col;
+        roll_guard_synthesizing = true;
+        action_exec(MAKE_KEYEVENT(roll_guard_key.row, roll_guard_key.col, false));
+        roll_guard_synthesizing = false;
+    }
+
+    uint16_t term = get_roll_guard_term(keycode, record);
+    bool left = is_left_hand(record);
+    roll_guard_current = term > 0 && has_last_press && left == last_press_left &&
+                         TIMER_DIFF_16(record->event.time, last_press_time) < term;
+    if (roll_guard_current) {
+        roll_guard_pending = true;
+        roll_guard_key = key;
+    }
+
+    has_last_press = true;
+    last_press_left = left;
+    last_press_time = record->event.time;
+    return true;
+}
+
+// Guarded key settled on its own (released before the next press, or held
+// past the tapping term)
+static void roll_guard_resolve(keyrecord_t *record) {
+    if (roll_guard_pending && record->event.pressed && same_key(record->event.key, roll_guard_key)) {
+        roll_guard_pending = false;
+    }
+}
+
+// Speculative hold: register harmless home-row mods (Shift/Ctrl) on press so
+// mod+click with a real mouse doesn't wait out the tapping term. If the key
+// resolves as a tap the mods are retracted with a cancel report before the
+// tap keycode goes out. GUI and Alt act on their own and are never applied.
+
+// Mods currently registered speculatively; the hold overlay leaves them out
+// so a home-row tap doesn't flash its mod
+static uint8_t speculative_mods = 0;
+
+#ifdef YXA_SPECULATIVE_HOLD
+
+#define SPECULATIVE_HOLD_EXCLUDED (MOD_MASK_GUI | MOD_MASK_ALT)
+#define MAX_SPECULATIVE_KEYS 4
+
+typedef struct {
+    keypos_t key;
+    uint8_t mods;  // Only the bits we added, never ones held by other keys
+} speculative_key_t;
+
+static speculative_key_t speculative_keys[MAX_SPECULATIVE_KEYS];
+static uint8_t speculative_count = 0;
+
+// Last tapped mod-tap, so a quick-tap repeat doesn't flash the mod
+static keypos_t last_tap_key = {.row = 255, .col = 255};
+static uint16_t last_tap_time = 0;
+
+static void speculative_hold_press(uint16_t keycode, keyrecord_t *record) {
+    if (!is_mod_tap(keycode) || speculative_count >= MAX_SPECULATIVE_KEYS) {
+        return;
+    }
+    if (same_key(record->event.key, last_tap_key) &&
+        TIMER_DIFF_16(record->event.time, last_tap_time) < yxa_tuning()->quick_tap_term) {
+        return;
+    }
+
+    uint8_t mods = mod_tap_mods(keycode) & (YXA_SPECULATIVE_HOLD_MODS) & ~SPECULATIVE_HOLD_EXCLUDED;
+    mods &= ~get_mods();
+    if (!mods) {
+        return;
+    }
+
+    speculative_keys[speculative_count].key = record->event.key;
+    speculative_keys[speculative_count].mods = mods;
+    speculative_count++;
+    speculative_mods |= mods;
+    register_mods(mods);
+}
+
+static void speculative_hold_resolve(uint16_t keycode, keyrecord_t *record) {
+    if (!is_mod_tap(keycode)) {
+        return;
+    }
+    if (!record->event.pressed) {
+        if (record->tap.count > 0) {
+            last_tap_key = record->event.key;
+            last_tap_time = record->event.time;
+        }
+        return;
+    }
+
+    for (uint8_t i = 0; i < speculative_count; i++) {
+        if (!same_key(speculative_keys[i].key, record->event.key)) {
+            continue;
+        }
+        // Tap: retract before the tap keycode is sent
+        // Hold: the mod-tap action now owns the mods and releases them itself
+        if (record->tap.count > 0) {
+            unregister_mods(speculative_keys[i].mods);
+        }
+        speculative_mods &= ~speculative_keys[i].mods;
+        speculative_keys[i] = speculative_keys[--speculative_count];
+        return;
+    }
+}
+
+#else
+
+static void speculative_hold_press(uint16_t keycode, keyrecord_t *record) {}
+static void speculative_hold_resolve(uint16_t keycode, keyrecord_t *record) {}
+
+#endif
+
+// Tap-hold buffer instrumentation: every key event passes pre_process_record
+// when it happens and process_record when action_tapping lets it through.
+// The gap is time spent buffered behind a pending mod-tap/layer-tap; the
+// number of events still in flight is the queue depth it saw.
+#ifdef YXA_TAPHOLD_STATS
+
+#define TAPHOLD_QUEUE_SIZE 16
+#define TAPHOLD_QUEUE_STALE_MS 2000  // Drop events some other feature swallowed
+#define TAPHOLD_WAIT_BUCKETS 10
+#define TAPHOLD_DEPTH_BUCKETS 4
+
+// Upper bound (ms) of each wait bucket; the last bucket catches the rest
+static const uint8_t taphold_wait_limits[TAPHOLD_WAIT_BUCKETS - 1] = {0, 1, 2, 5, 10, 20, 50, 100, 200};
+
+typedef struct {
+    keypos_t key;
+    bool pressed;
+    uint16_t time;
+} taphold_event_t;
+
+static taphold_event_t taphold_queue[TAPHOLD_QUEUE_SIZE];
+static uint8_t taphold_queue_count = 0;
+
+static uint16_t taphold_wait_hist[TAPHOLD_WAIT_BUCKETS];
+static uint16_t taphold_depth_hist[TAPHOLD_DEPTH_BUCKETS];  // depth 1, 2, 3, 4+
+static uint8_t taphold_max_depth = 0;
+
+static void taphold_queue_remove(uint8_t index) {
+    for (uint8_t i = index; i + 1 < taphold_queue_count; i++) {
+        taphold_queue[i] = taphold_queue[i + 1];
+    }
+    taphold_queue_count--;
+}
+
+static inline void hist_increment(uint16_t *bucket) {
+    if (*bucket < UINT16_MAX) {
+        (*bucket)++;
+    }
+}
+
+static void taphold_stats_enqueue(keyrecord_t *record) {
+    // Expire entries that never reached process_record_user
+    while (taphold_queue_count > 0 &&
+           timer_elapsed(taphold_queue[0].time) > TAPHOLD_QUEUE_STALE_MS) {
+        taphold_queue_remove(0);
+    }
+    if (taphold_queue_count >= TAPHOLD_QUEUE_SIZE) {
+        taphold_queue_remove(0);
+    }
+
+    taphold_queue[taphold_queue_count].key = record->event.key;
+    taphold_queue[taphold_queue_count].pressed = record->event.pressed;
+    taphold_queue[taphold_queue_count].time = timer_read();
+    taphold_queue_count++;
+}
+
+static void taphold_stats_dequeue(keyrecord_t *record) {
+    for (uint8_t i = 0; i < taphold_queue_count; i++) {
+        taphold_event_t *ev = &taphold_queue[i];
+        if (ev->key.row != record->event.key.row || ev->key.col != record->event.key.col ||
+            ev->pressed != record->event.pressed) {
+            continue;
+        }
+
+        uint16_t wait = timer_elapsed(ev->time);
+        uint8_t bucket = 0;
+        while (bucket < TAPHOLD_WAIT_BUCKETS - 1 && wait > taphold_wait_limits[bucket]) {
+            bucket++;
+        }
+        hist_increment(&taphold_wait_hist[bucket]);
+
+        // Depth counts this event plus everything queued behind it
+        uint8_t depth = taphold_queue_count - i;
+        hist_increment(&taphold_depth_hist[MIN(depth, TAPHOLD_DEPTH_BUCKETS) - 1]);
+        if (depth > taphold_max_depth) {
+            taphold_max_depth = depth;
+        }
+
+        taphold_queue_remove(i);
+        return;
+    }
+}
+
+// Response: [1] max depth, [2..21] wait histogram, [22..29] depth histogram,
+// [30] 1 (stats compiled in)
+// Histogram counts are little-endian uint16 and saturate at 0xFFFF
+static void taphold_stats_send(uint8_t *data) {
+    uint8_t response[RAW_EPSIZE] = {0};
+    response[0] = MSG_TAPHOLD_STATS;
+    response[1] = taphold_max_depth;
+    for (uint8_t i = 0; i < TAPHOLD_WAIT_BUCKETS; i++) {
+        put_u16(&response[2 + i * 2], taphold_wait_hist[i]);
+    }
+    for (uint8_t i = 0; i < TAPHOLD_DEPTH_BUCKETS; i++) {
+        put_u16(&response[22 + i * 2], taphold_depth_hist[i]);
+    }
+    response[30] = 1;
+    raw_hid_send(response, RAW_EPSIZE);
+
+    if (data[1] == 1) {
+        memset(taphold_wait_hist, 0, sizeof(taphold_wait_hist));
+        memset(taphold_depth_hist, 0, sizeof(taphold_depth_hist));
+        taphold_max_depth = 0;
+    }
+}
+
+#else
+
+static void taphold_stats_enqueue(keyrecord_t *record) {}
+static void taphold_stats_dequeue(keyrecord_t *record) {}
+// Built without YXA_TAPHOLD_STATS: all zero, [30] 0 so the host can tell
+static void taphold_stats_send(uint8_t *data) {
+    uint8_t response[RAW_EPSIZE] = {0};
+    response[0] = MSG_TAPHOLD_STATS;
+    raw_hid_send(response, RAW_EPSIZE);
+}
+
+#endif
+
+// ============================================================================
+// Kinetic Mouse Keys
+// ============================================================================
+
+// Cursor and wheel keys are taken from QMK's mousekey (a constant 3 px
+// every 16 ms, one wheel detent every 80 ms) and driven here. Each axis has
+// a signed 8.8 fixed-point velocity in units per tick: it ramps from the
+// profile's start speed to its max while a key is held and decays by the
+// profile's friction after release. Whole units go out every tick and the
+// fraction carries over to the next, so slow speeds still move evenly
+// instead of rounding to zero. The cursor ticks every YXA_MOUSE_INTERVAL_MS
+// in pixels; the wheel every YXA_MOUSE_WHEEL_INTERVAL_MS in hi-res wheel
+// units (1/POINTING_DEVICE_HIRES_SCROLL_MULTIPLIER of a detent) when the
+// resolution multiplier is in the report descriptor, whole detents if not.
+// Both run off one timer, the wheel on every MOUSE_WHEEL_TICKS-th tick, so
+// cursor and wheel steps land in the same tick.
+//
+// All the buttons are handled here too (QMK's mousekey report would drop
+// the ones held here), so every mouse report comes from one place: steps
+// collect in a pending report that goes out at most once per USB frame,
+// and a button change goes out at once, carrying whatever movement is
+// pending with it.
+#ifdef MOUSEKEY_ENABLE
+
+#ifdef POINTING_DEVICE_HIRES_SCROLL_ENABLE
+#    define MOUSE_WHEEL_UNITS POINTING_DEVICE_HIRES_SCROLL_MULTIPLIER
+#else
+#    define MOUSE_WHEEL_UNITS 1
+#endif
+
+// Units/s -> 8.8 units per tick
+#define MOUSE_SPEED(per_s, interval) ((int32_t)(per_s) * 256 * (interval) / 1000)
+#define MOUSE_PROFILE(name, scale, interval) {                                                                        \
+    .start = MOUSE_SPEED(YXA_MOUSE_##name##_START * (scale), interval),                                              \
+    .max = MOUSE_SPEED(YXA_MOUSE_##name##_MAX * (scale), interval),                                                  \
+    .accel = MAX((MOUSE_SPEED(YXA_MOUSE_##name##_MAX * (scale), interval) - MOUSE_SPEED(YXA_MOUSE_##name##_START * (scale), interval)) \
+                     * (interval) / MAX(YXA_MOUSE_##name##_TIME_TO_MAX, 1), 1),                                      \
+    .friction = YXA_MOUSE_##name##_FRICTION,                                                                         \
+}
+
+// Runtime speed scaling (tuning block), % of the configured speeds
+#define MOUSE_SPEED_PERCENT_MIN 25
+#define MOUSE_SPEED_PERCENT_MAX 200
+
+_Static_assert(MOUSE_SPEED(YXA_MOUSE_PRECISE_MAX * 2, YXA_MOUSE_INTERVAL_MS) < 127 * 256 && MOUSE_SPEED(YXA_MOUSE_NORMAL_MAX * 2, YXA_MOUSE_INTERVAL_MS) < 127 * 256
+               && MOUSE_SPEED(YXA_MOUSE_FAST_MAX * 2, YXA_MOUSE_INTERVAL_MS) < 127 * 256, "Mouse speed over 127 px per report");
+_Static_assert(MOUSE_SPEED(YXA_MOUSE_WHEEL_MAX * MOUSE_WHEEL_UNITS * 2, YXA_MOUSE_WHEEL_INTERVAL_MS) < 127 * 256, "Wheel speed over 127 units per report");
+_Static_assert(YXA_MOUSE_WHEEL_INTERVAL_MS % YXA_MOUSE_INTERVAL_MS == 0, "Wheel interval must be a whole number of cursor ticks");
+
+#define MOUSE_WHEEL_TICKS (YXA_MOUSE_WHEEL_INTERVAL_MS / YXA_MOUSE_INTERVAL_MS)
+
+enum { MOUSE_PRECISE, MOUSE_NORMAL, MOUSE_FAST, MOUSE_PROFILE_COUNT };
+enum { MOUSE_X, MOUSE_Y, MOUSE_V, MOUSE_H, MOUSE_AXES };
+
+typedef struct {
+    int16_t start;     // 8.8 units per tick
+    int16_t max;
+    int16_t accel;     // Added per tick while held
+    uint8_t friction;  // Speed kept per tick after release, of 256
+} mouse_profile_t;
+
+static const mouse_profile_t mouse_profiles[MOUSE_PROFILE_COUNT] = {
+    [MOUSE_PRECISE] = MOUSE_PROFILE(PRECISE, 1, YXA_MOUSE_INTERVAL_MS),
+    [MOUSE_NORMAL] = MOUSE_PROFILE(NORMAL, 1, YXA_MOUSE_INTERVAL_MS),
+    [MOUSE_FAST] = MOUSE_PROFILE(FAST, 1, YXA_MOUSE_INTERVAL_MS),
+};
+static const mouse_profile_t wheel_profile = MOUSE_PROFILE(WHEEL, MOUSE_WHEEL_UNITS, YXA_MOUSE_WHEEL_INTERVAL_MS);
+
+static uint8_t mouse_held_profile = UINT8_MAX;  // KC_ACL0-2 while held
+
+static uint16_t mouse_keys = 0;       // Held cursor/wheel keys, bit (keycode - KC_MS_UP)
+static int16_t mouse_vel[MOUSE_AXES];
+static int16_t mouse_rem[MOUSE_AXES];  // Sub-unit travel not yet reported
+static bool mouse_running = false;
+static bool wheel_running = false;
+static uint16_t mouse_last_tick = 0;  // Shared by cursor and wheel
+static uint8_t wheel_ticks = 0;       // Ticks since the last wheel step
+
+static uint8_t mouse_buttons = 0;
+static int16_t mouse_pending[MOUSE_AXES];  // Whole units waiting for a report
+static uint16_t mouse_last_report = 0;
+
+static uint32_t mouse_steps = 0;  // Ticks that moved the cursor
+static uint32_t wheel_steps = 0;  // ...or the wheel
+static uint32_t mouse_reports = 0;
+static uint32_t mouse_button_reports = 0;
+
+#define MOUSE_KEY(kc) ((mouse_keys >> ((kc) - KC_MS_UP)) & 1)
+
+static void mouse_report_send(void) {
+    report_mouse_t report = {.buttons = mouse_buttons};
+    report.x = MAX(MIN(mouse_pending[MOUSE_X], 127), -127);
+    report.y = MAX(MIN(mouse_pending[MOUSE_Y], 127), -127);
+    report.v = MAX(MIN(mouse_pending[MOUSE_V], 127), -127);
+    report.h = MAX(MIN(mouse_pending[MOUSE_H], 127), -127);
+    mouse_pending[MOUSE_X] -= report.x;
+    mouse_pending[MOUSE_Y] -= report.y;
+    mouse_pending[MOUSE_V] -= report.v;
+    mouse_pending[MOUSE_H] -= report.h;
+
+    host_mouse_send(&report);
+    mouse_last_report = timer_read();
+    mouse_reports++;
+}
+
+// Returns false for keys the engine takes over
+static bool mouse_keys_process(uint16_t keycode, keyrecord_t *record) {
+    if (keycode >= KC_MS_BTN1 && keycode <= KC_MS_BTN8) {
+        uint8_t bit = 1 << (keycode - KC_MS_BTN1);
+        if (record->event.pressed) {
+            mouse_buttons |= bit;
+        } else {
+            mouse_buttons &= ~bit;
+        }
+        // Never held back for the frame limit
+        mouse_report_send();
+        mouse_button_reports++;
+        return false;
+    }
+    bool cursor = keycode >= KC_MS_UP && keycode <= KC_MS_RIGHT;
+    if (cursor || (keycode >= KC_MS_WH_UP && keycode <= KC_MS_WH_RIGHT)) {
+        uint16_t bit = 1 << (keycode - KC_MS_UP);
+        if (!record->event.pressed) {
+            mouse_keys &= ~bit;
+            return false;
+        }
+        mouse_keys |= bit;
+        // From a standstill, first step on the next housekeeping pass;
+        // otherwise on the next tick of the one already running
+        if (!mouse_running && !wheel_running) {
+            mouse_last_tick = timer_read() - YXA_MOUSE_INTERVAL_MS;
+        }
+        if (cursor) {
+            mouse_running = true;
+        } else if (!wheel_running) {
+            wheel_running = true;
+            wheel_ticks = MOUSE_WHEEL_TICKS - 1;
+        }
+        return false;
+    }
+    if (keycode >= KC_MS_ACCEL0 && keycode <= KC_MS_ACCEL2) {
+        uint8_t profile = keycode - KC_MS_ACCEL0;
+        if (record->event.pressed) {
+            mouse_held_profile = profile;
+        } else if (mouse_held_profile == profile) {
+            mouse_held_profile = UINT8_MAX;
+        }
+        return false;
+    }
+    return true;
+}
+
+// Advance one axis by a tick; returns the whole units to report
+static int8_t mouse_axis_step(uint8_t axis, int8_t dir, const mouse_profile_t *profile, bool diagonal) {
+    int16_t vel = mouse_vel[axis];
+    int16_t speed = vel < 0 ? -vel : vel;
+
+    if (dir == 0) {
+        speed = speed * profile->friction >> 8;
+        dir = vel < 0 ? -1 : 1;
+    } else if (speed == 0 || (vel < 0) != (dir < 0)) {
+        speed = profile->start;  // Starting, or turned around
+    } else {
+        speed = MIN(speed + profile->accel, profile->max);
+    }
+    mouse_vel[axis] = dir * speed;
+
+    // Both axes moving: scale each by 1/sqrt(2) so diagonals aren't faster
+    mouse_rem[axis] += diagonal ? mouse_vel[axis] * 181 / 256 : mouse_vel[axis];
+    int8_t move = mouse_rem[axis] / 256;
+    mouse_rem[axis] -= move * 256;
+    return move;
+}
+
+// Ticks due on the timer at *last; false if it isn't time yet
+static bool mouse_tick_due(uint16_t *last, uint16_t interval) {
+    if (timer_elapsed(*last) < interval) {
+        return false;
+    }
+    *last += interval;
+    if (timer_elapsed(*last) >= interval) {
+        *last = timer_read();  // Fell behind: skip, don't burst
+    }
+    return true;
+}
+
+// Profile with the tuning block's speed applied
+static bool mouse_tuning_valid(const yxa_tuning_t *tuning) {
+    return tuning->mouse_profile < MOUSE_PROFILE_COUNT && tuning->mouse_speed >= MOUSE_SPEED_PERCENT_MIN && tuning->mouse_speed <= MOUSE_SPEED_PERCENT_MAX
+           && tuning->wheel_speed >= MOUSE_SPEED_PERCENT_MIN && tuning->wheel_speed <= MOUSE_SPEED_PERCENT_MAX;
+}
+
+static mouse_profile_t mouse_profile_scaled(const mouse_profile_t *profile, uint8_t percent) {
+    return (mouse_profile_t){
+        .start = MAX(profile->start * percent / 100, 1),
+        .max = MAX(profile->max * percent / 100, 1),
+        .accel = MAX(profile->accel * percent / 100, 1),
+        .friction = profile->friction,
+    };
+}
+
+static bool mouse_axes_stopped(uint8_t first) {
+    if (mouse_vel[first] || mouse_vel[first + 1]) {
+        return false;
+    }
+    mouse_rem[first] = 0;
+    mouse_rem[first + 1] = 0;
+    return true;
+}
+
+// One tick of the shared timer: cursor step, and a wheel step when due
+static void mouse_tick(void) {
+    if (mouse_running) {
+        uint8_t index = mouse_held_profile < MOUSE_PROFILE_COUNT ? mouse_held_profile : yxa_tuning()->mouse_profile;
+        mouse_profile_t profile = mouse_profile_scaled(&mouse_profiles[index], yxa_tuning()->mouse_speed);
+        int8_t dir_x = MOUSE_KEY(KC_MS_RIGHT) - MOUSE_KEY(KC_MS_LEFT);
+        int8_t dir_y = MOUSE_KEY(KC_MS_DOWN) - MOUSE_KEY(KC_MS_UP);
+        bool diagonal = mouse_vel[MOUSE_X] && mouse_vel[MOUSE_Y];
+
+        int8_t x = mouse_axis_step(MOUSE_X, dir_x, &profile, diagonal);
+        int8_t y = mouse_axis_step(MOUSE_Y, dir_y, &profile, diagonal);
+        if (x || y) {
+            mouse_pending[MOUSE_X] += x;
+            mouse_pending[MOUSE_Y] += y;
+            mouse_steps++;
+        }
+        mouse_running = !mouse_axes_stopped(MOUSE_X);
+    }
+
+    if (wheel_running && ++wheel_ticks >= MOUSE_WHEEL_TICKS) {
+        wheel_ticks = 0;
+        int8_t dir_v = MOUSE_KEY(KC_MS_WH_UP) - MOUSE_KEY(KC_MS_WH_DOWN);
+        int8_t dir_h = MOUSE_KEY(KC_MS_WH_RIGHT) - MOUSE_KEY(KC_MS_WH_LEFT);
+
+        mouse_profile_t profile = mouse_profile_scaled(&wheel_profile, yxa_tuning()->wheel_speed);
+        int8_t v = mouse_axis_step(MOUSE_V, dir_v, &profile, false);
+        int8_t h = mouse_axis_step(MOUSE_H, dir_h, &profile, false);
+        if (v || h) {
+            mouse_pending[MOUSE_V] += v;
+            mouse_pending[MOUSE_H] += h;
+            wheel_steps++;
+        }
+        wheel_running = !mouse_axes_stopped(MOUSE_V);
+    }
+}
+
+static void mouse_keys_task(void) {
+    if ((mouse_running || wheel_running) && mouse_tick_due(&mouse_last_tick, YXA_MOUSE_INTERVAL_MS)) {
+        mouse_tick();
+    }
+
+    // One report per USB frame (1 ms poll) for everything pending
+    bool pending = mouse_pending[MOUSE_X] || mouse_pending[MOUSE_Y] || mouse_pending[MOUSE_V] || mouse_pending[MOUSE_H];
+    if (pending && timer_elapsed(mouse_last_report) >= USB_POLLING_INTERVAL_MS) {
+        mouse_report_send();
+    }
+}
+
+// Request: [1] base profile to select (0 precise, 1 normal, 2 fast), 0xFF
+// to only read. The selection is saved in the tuning block.
+// Response: [1] base profile, [2] profile in use (KC_ACL0-2 held), [3]
+// cursor tick (ms), [4..7] ticks that moved the cursor, [8] wheel tick
+// (ms), [9] wheel units per detent, [10..13] ticks that moved the wheel,
+// [14..17] mouse reports sent, [18..21] of those for button changes
+static void mouse_profile_send(uint8_t *data) {
+    if (data[1] < MOUSE_PROFILE_COUNT) {
+        yxa_tuning_t tuning = *yxa_tuning();
+        tuning.mouse_profile = data[1];
+        yxa_tuning_set(&tuning);
+    }
+
+    uint8_t base = yxa_tuning()->mouse_profile;
+    uint8_t response[RAW_EPSIZE] = {0};
+    response[0] = MSG_MOUSE_PROFILE;
+    response[1] = base;
+    response[2] = mouse_held_profile < MOUSE_PROFILE_COUNT ? mouse_held_profile : base;
+    response[3] = YXA_MOUSE_INTERVAL_MS;
+    put_u32(&response[4], mouse_steps);
+    response[8] = YXA_MOUSE_WHEEL_INTERVAL_MS;
+    response[9] = MOUSE_WHEEL_UNITS;
+    put_u32(&response[10], wheel_steps);
+    put_u32(&response[14], mouse_reports);
+    put_u32(&response[18], mouse_button_reports);
+    raw_hid_send(response, RAW_EPSIZE);
+}
+
+#else
+
+static bool mouse_keys_process(uint16_t keycode, keyrecord_t *record) { return true; }
+static void mouse_keys_task(void) {}
+static void mouse_profile_send(uint8_t *data) {}
+static bool mouse_tuning_valid(const yxa_tuning_t *tuning) { return true; }
+
+#endif
+
 
 // RGB Matrix layer indication
 #ifdef RGB_MATRIX_ENABLE
@@ -343,76 +1265,376 @@ const uint8_t FINGER_COLORS[][2] = {
     {170, 255}  // 4: thumb - blue
 };
 
-// Helper to set LED color from HSV
-static inline void set_led_hsv(uint8_t led, uint8_t h, uint8_t s, uint8_t v) {
-    HSV hsv = {h, s, v};
-    RGB rgb = hsv_to_rgb(hsv);
-    rgb_matrix_set_color(led, rgb.r, rgb.g, rgb.b);
+// Layer colors {h, s, v} at RGB_LAYER_BRIGHTNESS, scaled to the tuning
+// block's brightness when the frames are built; layer 0 colors each key by
+// finger instead
+const uint8_t LAYER_COLORS[][3] = {
+    {0, 0, RGB_LAYER_BRIGHTNESS},      // 0: BASE - finger colors
+    {0, 0, RGB_LAYER_BRIGHTNESS},      // 1: EXTRA - white
+    {128, 255, RGB_TAP_BRIGHTNESS},    // 2: TAP - dim cyan, tap-only mode
+    {21, 255, RGB_LAYER_BRIGHTNESS},   // 3: BUTTON - orange
+    {128, 255, RGB_LAYER_BRIGHTNESS},  // 4: NAV - cyan
+    {43, 255, RGB_LAYER_BRIGHTNESS},   // 5: MOUSE - yellow
+    {213, 255, RGB_LAYER_BRIGHTNESS},  // 6: MEDIA - purple
+    {170, 255, RGB_LAYER_BRIGHTNESS},  // 7: NUM - blue
+    {85, 255, RGB_LAYER_BRIGHTNESS},   // 8: SYM - green
+    {0, 255, RGB_LAYER_BRIGHTNESS},    // 9: FUN - red
+};
+
+#define LAYER_FRAME_COUNT ARRAY_SIZE(LAYER_COLORS)
+#define LAYER_FRAME_LEDS 36
+
+// Keypress heatmap (RGB_MATRIX_CUSTOM_YXA_HEATMAP, see rgb_matrix_user.inc)
+//
+// Each half tracks its own keys: heat is 8.8 fixed point per LED, raised on
+// every press and decayed exponentially every YXA_HEATMAP_DECAY_MS. Keys
+// keep their finger's hue (FINGER_MAP) and get brighter as they heat up;
+// the colors come from a palette converted once, like the layer frames.
+#define HEAT_LEVELS 16
+
+static uint16_t heat[LAYER_FRAME_LEDS];
+static RGB heat_palette[ARRAY_SIZE(FINGER_COLORS)][HEAT_LEVELS];
+
+static void heat_palette_build(void) {
+    uint8_t brightness = MAX(yxa_tuning()->rgb_brightness, YXA_HEATMAP_MIN_BRIGHTNESS);
+    for (uint8_t finger = 0; finger < ARRAY_SIZE(FINGER_COLORS); finger++) {
+        for (uint8_t level = 0; level < HEAT_LEVELS; level++) {
+            // Cold keys stay faintly lit so the layout remains visible
+            uint8_t v = YXA_HEATMAP_MIN_BRIGHTNESS + (brightness - YXA_HEATMAP_MIN_BRIGHTNESS) * level / (HEAT_LEVELS - 1);
+            HSV hsv = {FINGER_COLORS[finger][0], FINGER_COLORS[finger][1], v};
+            heat_palette[finger][level] = hsv_to_rgb(hsv);
+        }
+    }
 }
 
-bool rgb_matrix_indicators_advanced_user(uint8_t led_min, uint8_t led_max) {
-    uint8_t layer = get_effective_layer();
+static void heatmap_task(void) {
+    static matrix_row_t last_rows[ROWS_PER_HAND];
+    static uint16_t last_decay = 0;
+
+    uint8_t first_row = is_keyboard_left() ? 0 : ROWS_PER_HAND;
+    for (uint8_t row = 0; row < ROWS_PER_HAND; row++) {
+        matrix_row_t rows = matrix_get_row(first_row + row);
+        matrix_row_t pressed = rows & ~last_rows[row];
+        last_rows[row] = rows;
 
-    // Layer 0 (BASE/Colemak-DH): Finger colors - main Miryoku layer
-    if (layer == 0) {
-        for (uint8_t i = led_min; i < led_max && i < 36; i++) {
-            uint8_t finger = FINGER_MAP[i];
-            set_led_hsv(i, FINGER_COLORS[finger][0], FINGER_COLORS[finger][1], RGB_LAYER_BRIGHTNESS);
+        for (uint8_t col = 0; pressed; col++, pressed >>= 1) {
+            uint8_t led = g_led_config.matrix_co[first_row + row][col];
+            if ((pressed & 1) && led < LAYER_FRAME_LEDS) {
+                heat[led] = MIN((uint32_t)heat[led] + YXA_HEATMAP_PRESS_HEAT, UINT16_MAX);
+            }
         }
-        return false;
     }
 
-    // Layer 1 (EXTRA/QWERTY): White
-    if (layer == 1) {
-        for (uint8_t i = led_min; i < led_max && i < 36; i++) {
-            set_led_hsv(i, 0, 0, RGB_LAYER_BRIGHTNESS);  // white
+    if (timer_elapsed(last_decay) >= YXA_HEATMAP_DECAY_MS) {
+        last_decay = timer_read();
+        for (uint8_t i = 0; i < LAYER_FRAME_LEDS; i++) {
+            // At least one fraction step so small values reach zero
+            uint16_t loss = heat[i] >> YXA_HEATMAP_DECAY_SHIFT;
+            heat[i] -= loss ? loss : (heat[i] ? 1 : 0);
         }
-        return false;
     }
+}
+
+// Every layer's full frame, converted from HSV once. Rebuild (invalidate)
+// whenever a color or brightness above changes; a new tuned brightness is
+// picked up on its own.
+static RGB layer_frames[LAYER_FRAME_COUNT][LAYER_FRAME_LEDS];
+static bool layer_frames_valid = false;
+static uint8_t layer_frames_brightness;
+
+static bool layer_frames_stale(void) {
+    return !layer_frames_valid || layer_frames_brightness != yxa_tuning()->rgb_brightness;
+}
 
-    // Layer 2 (TAP): Dim cyan - tap-only mode indicator
-    if (layer == 2) {
-        for (uint8_t i = led_min; i < led_max && i < 36; i++) {
-            set_led_hsv(i, 128, 255, RGB_TAP_BRIGHTNESS);  // dim cyan
+static void layer_frames_build(void) {
+    layer_frames_brightness = yxa_tuning()->rgb_brightness;
+    for (uint8_t layer = 0; layer < LAYER_FRAME_COUNT; layer++) {
+        for (uint8_t i = 0; i < LAYER_FRAME_LEDS; i++) {
+            uint8_t v = LAYER_COLORS[layer][2] * layer_frames_brightness / RGB_LAYER_BRIGHTNESS;
+            HSV hsv = {LAYER_COLORS[layer][0], LAYER_COLORS[layer][1], v};
+            if (layer == 0) {
+                uint8_t finger = FINGER_MAP[i];
+                hsv.h = FINGER_COLORS[finger][0];
+                hsv.s = FINGER_COLORS[finger][1];
+            }
+            layer_frames[layer][i] = hsv_to_rgb(hsv);
         }
-        return false;
     }
+    heat_palette_build();
+    layer_frames_valid = true;
+}
 
-    // For layers 3-9, color ALL keys in the layer's designated color
-    uint8_t h, s;
+static const RGB *heat_color(uint8_t led) {
+    return &heat_palette[FINGER_MAP[led]][(heat[led] >> 8) * HEAT_LEVELS / 256];
+}
 
-    switch (layer) {
-        case 3:  // BUTTON - orange
-            h = 21; s = 255;
-            break;
-        case 4:  // NAV - cyan
-            h = 128; s = 255;
-            break;
-        case 5:  // MOUSE - yellow
-            h = 43; s = 255;
-            break;
-        case 6:  // MEDIA - purple
-            h = 213; s = 255;
-            break;
-        case 7:  // NUM - blue
-            h = 170; s = 255;
-            break;
-        case 8:  // SYM - green
-            h = 85; s = 255;
-            break;
-        case 9:  // FUN - red
-            h = 0; s = 255;
-            break;
-        default:
-            h = 0; s = 0;  // white fallback
-            break;
+// Called from the effect in rgb_matrix_user.inc
+void yxa_heatmap_render(uint8_t led_min, uint8_t led_max) {
+    if (layer_frames_stale()) {
+        layer_frames_build();
+    }
+    for (uint8_t i = led_min; i < led_max && i < LAYER_FRAME_LEDS; i++) {
+        const RGB *rgb = heat_color(i);
+        rgb_matrix_set_color(i, rgb->r, rgb->g, rgb->b);
+    }
+}
+
+// Hold overlay: tints the home-row LEDs of active modifiers toward white and
+// pulses a layer-tap key while its tap-hold is undecided. The master only
+// updates the overlay byte when mods or the pending key change; which LED
+// belongs to which mod or layer-tap is read from the BASE keymap once.
+#define OVERLAY_LT_SLOTS 15
+
+static uint8_t led_mods[LAYER_FRAME_LEDS];  // Ctrl/Shift/Alt/GUI of the LED's mod-tap
+static uint8_t lt_leds[OVERLAY_LT_SLOTS];   // Layer-tap LEDs in matrix order
+static uint8_t lt_layers[OVERLAY_LT_SLOTS];  // ...and the layer each one holds
+static uint8_t lt_count = 0;
+static bool overlay_tables_valid = false;
+
+// Master: pending layer-tap as slot + 1, and the key holding it
+static uint8_t overlay_pending = 0;
+static keypos_t overlay_pending_key;
+
+static void overlay_tables_build(void) {
+    lt_count = 0;
+    for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+        for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+            uint8_t led = g_led_config.matrix_co[row][col];
+            if (led >= LAYER_FRAME_LEDS) {
+                continue;
+            }
+            uint16_t keycode = keymap_key_to_keycode(0, MAKE_KEYPOS(row, col));
+            if (is_mod_tap(keycode)) {
+                led_mods[led] = QK_MOD_TAP_GET_MODS(keycode) & YXA_OVERLAY_MODS_MASK;
+            } else if (is_layer_tap(keycode) && lt_count < OVERLAY_LT_SLOTS) {
+                lt_leds[lt_count] = led;
+                lt_layers[lt_count++] = QK_LAYER_TAP_GET_LAYER(keycode);
+            }
+        }
+    }
+    overlay_tables_valid = true;
+}
+
+static void overlay_pending_press(uint16_t keycode, keyrecord_t *record) {
+    if (!is_layer_tap(keycode)) {
+        return;
+    }
+    if (!overlay_tables_valid) {
+        overlay_tables_build();
+    }
+    uint8_t led = g_led_config.matrix_co[record->event.key.row][record->event.key.col];
+    for (uint8_t slot = 0; slot < lt_count; slot++) {
+        if (lt_leds[slot] == led) {
+            overlay_pending = slot + 1;
+            overlay_pending_key = record->event.key;
+            return;
+        }
+    }
+}
+
+// The key's event reached process_record: tap-hold has decided
+static void overlay_pending_resolve(keyrecord_t *record) {
+    if (overlay_pending && record->event.key.row == overlay_pending_key.row && record->event.key.col == overlay_pending_key.col) {
+        overlay_pending = 0;
+    }
+}
+
+static void overlay_update(void) {
+    uint8_t mods = get_modifier_state() & ~speculative_mods;
+    yxa_overlay_set(((mods | mods >> 4) & YXA_OVERLAY_MODS_MASK) | (overlay_pending << YXA_OVERLAY_PENDING_SHIFT));
+}
+
+// Draws over whatever the frame (or the heatmap, frame == NULL) put there
+static void overlay_render(uint8_t led_min, uint8_t led_max, const RGB *frame) {
+    uint8_t overlay = yxa_overlay_get();
+    if (!overlay) {
+        return;
+    }
+    if (!overlay_tables_valid) {
+        overlay_tables_build();
+    }
+
+    uint8_t mods = overlay & YXA_OVERLAY_MODS_MASK;
+    for (uint8_t i = led_min; mods && i < led_max && i < LAYER_FRAME_LEDS; i++) {
+        if (led_mods[i] & mods) {
+            const RGB *base = frame ? &frame[i] : heat_color(i);
+            rgb_matrix_set_color(i, base->r + (((255 - base->r) * 3) >> 2), base->g + (((255 - base->g) * 3) >> 2), base->b + (((255 - base->b) * 3) >> 2));
+        }
+    }
+
+    uint8_t pending = overlay >> YXA_OVERLAY_PENDING_SHIFT;
+    if (pending && pending <= lt_count) {
+        uint8_t led = lt_leds[pending - 1];
+        if (led >= led_min && led < led_max) {
+            // Triangle wave, 512 ms period
+            uint8_t phase = timer_read() >> 1;
+            uint8_t wave = phase < 128 ? phase * 2 : (255 - phase) * 2;
+            const RGB *base = frame ? &frame[led] : heat_color(led);
+            rgb_matrix_set_color(led, base->r * wave >> 8, base->g * wave >> 8, base->b * wave >> 8);
+        }
+    }
+}
+
+// Layer transitions: the new layer's frame fades in over the frame that was
+// showing, as a ripple from the layer-tap key that holds the new layer (the
+// first one in the BASE keymap), or as a plain crossfade if there is none.
+// Both halves work it out from the synced layer alone. Blending is 8.8
+// fixed point. Rendering is timed: if an animation frame costs more than
+// YXA_RGB_ANIM_BUDGET_US, the next one is dropped and the last output shown
+// again, so a slow animation loses frames instead of scan time. Leaving the
+// heatmap fades from the last heatmap frame that was drawn.
+#define ANIM_HEATMAP (UINT8_MAX - 1)  // anim_layer while the heatmap shows
+
+static RGB anim_from[LAYER_FRAME_LEDS];
+static RGB anim_out[LAYER_FRAME_LEDS];
+static uint8_t anim_layer = UINT8_MAX;  // Layer the animation is heading to
+static uint8_t anim_origin = NO_LED;    // Ripple center, NO_LED to crossfade
+static uint16_t anim_start = 0;
+static bool anim_active = false;
+static bool anim_drop_next = false;
+
+static uint16_t anim_drawn = 0;
+static uint16_t anim_dropped = 0;
+static uint32_t anim_cycles_max = 0;
+
+static void anim_stats_put(uint8_t *out, bool reset) {
+    put_u16(&out[0], anim_drawn);
+    put_u16(&out[2], anim_dropped);
+    put_u16(&out[4], MIN(anim_cycles_max / YXA_CYCLES_PER_US, UINT16_MAX));
+    if (reset) {
+        anim_drawn = 0;
+        anim_dropped = 0;
+        anim_cycles_max = 0;
+    }
+}
+
+static uint8_t anim_ripple_origin(uint8_t layer) {
+    if (!overlay_tables_valid) {
+        overlay_tables_build();
+    }
+    for (uint8_t slot = 0; slot < lt_count; slot++) {
+        if (lt_layers[slot] == layer) {
+            return lt_leds[slot];
+        }
+    }
+    return NO_LED;
+}
+
+// Start delay of a LED: its distance from the ripple center (octagonal
+// approximation) scaled so the ripple crosses the board in YXA_RGB_RIPPLE_MS
+static uint16_t anim_delay(uint8_t led) {
+    if (anim_origin == NO_LED) {
+        return 0;
+    }
+    uint8_t x = g_led_config.point[led].x, ox = g_led_config.point[anim_origin].x;
+    uint8_t y = g_led_config.point[led].y, oy = g_led_config.point[anim_origin].y;
+    uint8_t dx = x > ox ? x - ox : ox - x;
+    uint8_t dy = y > oy ? y - oy : oy - y;
+    uint16_t dist = dx > dy ? dx + dy / 2 : dy + dx / 2;
+    return dist * YXA_RGB_RIPPLE_MS / 224;
+}
+
+static uint8_t blend(uint8_t from, uint8_t to, uint16_t progress) {
+    return from + (((int16_t)to - from) * progress >> 8);
+}
+
+// Frame to show for this layer: the target itself, or an animation step
+static const RGB *anim_frame(uint8_t layer, const RGB *target, uint8_t led_min, uint8_t led_max) {
+    if (layer != anim_layer) {
+        if (anim_layer != UINT8_MAX) {
+            // Coming from the heatmap, anim_from already holds what it showed
+            if (anim_layer != ANIM_HEATMAP) {
+                const RGB *shown = anim_active ? anim_out : layer_frames[anim_layer < LAYER_FRAME_COUNT ? anim_layer : 1];
+                memcpy(anim_from, shown, sizeof(anim_from));
+            }
+            anim_origin = anim_ripple_origin(layer);
+            anim_start = timer_read();
+            anim_active = true;
+            anim_drop_next = false;
+        }
+        anim_layer = layer;
+    }
+    if (!anim_active) {
+        return target;
+    }
+
+    uint16_t elapsed = timer_elapsed(anim_start);
+    if (elapsed >= YXA_RGB_FADE_MS + (anim_origin == NO_LED ? 0 : YXA_RGB_RIPPLE_MS)) {
+        anim_active = false;
+        return target;
+    }
+    if (anim_drop_next) {
+        anim_drop_next = false;
+        anim_dropped++;
+        return anim_out;
+    }
+
+    uint32_t start = yxa_cycles();
+    for (uint8_t i = led_min; i < led_max && i < LAYER_FRAME_LEDS; i++) {
+        uint16_t delay = anim_delay(i);
+        uint16_t progress = 0;
+        if (elapsed > delay) {
+            progress = MIN((uint32_t)(elapsed - delay) * 256 / YXA_RGB_FADE_MS, 256);
+        }
+        anim_out[i].r = blend(anim_from[i].r, target[i].r, progress);
+        anim_out[i].g = blend(anim_from[i].g, target[i].g, progress);
+        anim_out[i].b = blend(anim_from[i].b, target[i].b, progress);
+    }
+    uint32_t cycles = yxa_cycles() - start;
+
+    anim_drawn++;
+    if (cycles > anim_cycles_max) {
+        anim_cycles_max = cycles;
+    }
+    if (cycles > YXA_RGB_ANIM_BUDGET_US * YXA_CYCLES_PER_US) {
+        anim_drop_next = true;
+    }
+    return anim_out;
+}
+
+// The heatmap was drawn instead of a layer frame: keep it as the starting
+// point of the next transition
+static void anim_heatmap_shown(uint8_t led_min, uint8_t led_max) {
+    for (uint8_t i = led_min; i < led_max && i < LAYER_FRAME_LEDS; i++) {
+        anim_from[i] = *heat_color(i);
+    }
+    anim_layer = ANIM_HEATMAP;
+    anim_active = false;
+}
+
+// Runs on both halves, each for its own LEDs. The layer comes from the
+// indicator state byte the master syncs over (yxa.c), so the slave needs
+// neither layer_state nor default_layer_state.
+bool rgb_matrix_indicators_advanced_user(uint8_t led_min, uint8_t led_max) {
+    if (layer_frames_stale()) {
+        layer_frames_build();
     }
 
-    // Apply the solid color to all LEDs in range
-    for (uint8_t i = led_min; i < led_max && i < 36; i++) {
-        set_led_hsv(i, h, s, RGB_LAYER_BRIGHTNESS);
+    // The heatmap replaces the BASE colors; other layers still show
+    uint8_t state = yxa_indicator_get();
+    uint8_t layer = state & YXA_INDICATOR_LAYER_MASK;
+    if (layer == 0 && (state >> YXA_INDICATOR_MODE_SHIFT) == YXA_RENDER_HEATMAP) {
+        anim_heatmap_shown(led_min, led_max);
+        overlay_render(led_min, led_max, NULL);
+        return false;
+    }
+
+    // Layers past the table show white (EXTRA's frame)
+    const RGB *frame = anim_frame(layer, layer_frames[layer < LAYER_FRAME_COUNT ? layer : 1], led_min, led_max);
+
+    for (uint8_t i = led_min; i < led_max && i < LAYER_FRAME_LEDS; i++) {
+        rgb_matrix_set_color(i, frame[i].r, frame[i].g, frame[i].b);
     }
+    overlay_render(led_min, led_max, frame);
 
     return false;
 }
+#else
+
+static void heatmap_task(void) {}
+static void overlay_pending_press(uint16_t keycode, keyrecord_t *record) {}
+static void overlay_pending_resolve(keyrecord_t *record) {}
+static void overlay_update(void) {}
+static void anim_stats_put(uint8_t *out, bool reset) {}
+
 #endif
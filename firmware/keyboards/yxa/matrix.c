@@ -0,0 +1,162 @@
+// Copyright 2025 Yxa
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+// Port-parallel direct-pin matrix reader.
+//
+// Every key has its own pin, spread over GPIOA-D. Rather than reading the
+// pins one by one, the pin map from keyboard.json (DIRECT_PINS for the left
+// half, DIRECT_PINS_RIGHT for the right) is turned into a list of ports with
+// a mask of used pads and a per-key (port, shift) table at init. A scan is
+// then one IDR read per port plus shifts.
+//
+// There is no idle sleep: both halves have 18 direct pins and the STM32 has
+// only 16 EXTI lines (one per pad number), so on any pinout some keys could
+// only be picked up by scanning, and the loop keeps scanning at full rate.
+
+#include "quantum.h"
+#include "matrix.h"
+#include "split_util.h"
+#include "debounce.h"
+#include "yxa.h"
+
+extern matrix_row_t raw_matrix[MATRIX_ROWS];
+extern matrix_row_t matrix[MATRIX_ROWS];
+extern uint8_t thisHand, thatHand;
+
+#define MAX_SCAN_PORTS 4
+#define NO_PORT 0xFF
+
+typedef struct {
+    uint8_t port;   // Index into scan_ports, NO_PORT for NO_PIN
+    uint8_t shift;  // Pad number within the port
+} key_bit_t;
+
+static const pin_t direct_pins_left[ROWS_PER_HAND][MATRIX_COLS] = DIRECT_PINS;
+static const pin_t direct_pins_right[ROWS_PER_HAND][MATRIX_COLS] = DIRECT_PINS_RIGHT;
+
+static ioportid_t scan_ports[MAX_SCAN_PORTS];
+static uint16_t port_masks[MAX_SCAN_PORTS];
+static uint8_t port_count = 0;
+static key_bit_t key_bits[ROWS_PER_HAND][MATRIX_COLS];
+
+// Scan statistics
+static uint32_t scans_this_second = 0;
+static uint32_t second_start = 0;
+static uint32_t read_cycles_total = 0;
+static uint32_t read_count = 0;
+static yxa_scan_stats_t scan_stats;
+
+static uint8_t port_index(ioportid_t port) {
+    for (uint8_t i = 0; i < port_count; i++) {
+        if (scan_ports[i] == port) {
+            return i;
+        }
+    }
+    if (port_count >= MAX_SCAN_PORTS) {
+        return NO_PORT;
+    }
+    scan_ports[port_count] = port;
+    port_masks[port_count] = 0;
+    return port_count++;
+}
+
+static void build_key_table(const pin_t pins[ROWS_PER_HAND][MATRIX_COLS]) {
+    port_count = 0;
+    for (uint8_t row = 0; row < ROWS_PER_HAND; row++) {
+        for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+            pin_t pin = pins[row][col];
+            key_bits[row][col].port = NO_PORT;
+            if (pin == NO_PIN) {
+                continue;
+            }
+
+            uint8_t index = port_index(PAL_PORT(pin));
+            if (index == NO_PORT) {
+                continue;
+            }
+            gpio_set_pin_input_high(pin);
+            key_bits[row][col].port = index;
+            key_bits[row][col].shift = PAL_PAD(pin);
+            port_masks[index] |= 1U << PAL_PAD(pin);
+        }
+    }
+}
+
+void matrix_init_custom(void) {
+    build_key_table(isLeftHand ? direct_pins_left : direct_pins_right);
+    second_start = timer_read32();
+}
+
+bool matrix_scan_custom(matrix_row_t current_matrix[]) {
+    uint32_t start = yxa_cycles();
+
+    // Pins are pulled up, a pressed key reads low
+    uint16_t pressed[MAX_SCAN_PORTS];
+    for (uint8_t p = 0; p < port_count; p++) {
+        pressed[p] = ~palReadPort(scan_ports[p]) & port_masks[p];
+    }
+
+    bool changed = false;
+    for (uint8_t row = 0; row < ROWS_PER_HAND; row++) {
+        matrix_row_t row_bits = 0;
+        for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+            const key_bit_t *kb = &key_bits[row][col];
+            if (kb->port != NO_PORT) {
+                row_bits |= (matrix_row_t)((pressed[kb->port] >> kb->shift) & 1) << col;
+            }
+        }
+        changed |= current_matrix[row] != row_bits;
+        current_matrix[row] = row_bits;
+    }
+
+    uint32_t cycles = yxa_cycles() - start;
+
+    read_cycles_total += cycles;
+    read_count++;
+    if (cycles > scan_stats.read_cycles_max) {
+        scan_stats.read_cycles_max = MIN(cycles, UINT16_MAX);
+    }
+
+    scans_this_second++;
+    if (timer_elapsed32(second_start) >= 1000) {
+        scan_stats.scan_rate = scans_this_second;
+        scan_stats.read_cycles_avg = MIN(read_cycles_total / read_count, UINT16_MAX);
+        scans_this_second = 0;
+        read_cycles_total = 0;
+        read_count = 0;
+        second_start = timer_read32();
+    }
+
+    return changed;
+}
+
+// This half after debounce; the master presents it through split_sync.c
+static matrix_row_t cooked[ROWS_PER_HAND];
+
+// Replaces the lite-matrix scan so the split exchange is ours (split_sync.c)
+uint8_t matrix_scan(void) {
+    bool changed = matrix_scan_custom(raw_matrix);
+
+    matrix_row_t before[ROWS_PER_HAND];
+    memcpy(before, cooked, sizeof(before));
+    changed = debounce(raw_matrix, cooked, ROWS_PER_HAND, changed);
+
+    if (is_keyboard_master()) {
+        return split_sync_master(before, cooked, changed);
+    }
+
+    if (changed) {
+        split_sync_log(before, cooked);
+        memcpy(matrix + thisHand, cooked, sizeof(cooked));
+    }
+    split_sync_slave(matrix + thatHand);
+    return changed;
+}
+
+void yxa_scan_stats_get(yxa_scan_stats_t *stats) {
+    *stats = scan_stats;
+}
+
+void yxa_scan_stats_reset(void) {
+    scan_stats.read_cycles_max = 0;
+}
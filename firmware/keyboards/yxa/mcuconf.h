@@ -5,9 +5,14 @@
 
 #include_next <mcuconf.h>
 
-// Split keyboard serial
-#undef STM32_SERIAL_USE_USART1
-#define STM32_SERIAL_USE_USART1 TRUE
+// Split keyboard serial; the full-duplex transport drives USART1 via DMA
+#ifdef YXA_SPLIT_DMA
+#    undef STM32_UART_USE_USART1
+#    define STM32_UART_USE_USART1 TRUE
+#else
+#    undef STM32_SERIAL_USE_USART1
+#    define STM32_SERIAL_USE_USART1 TRUE
+#endif
 
 // WS2812 PWM on TIM3
 #undef STM32_PWM_USE_TIM3
@@ -0,0 +1,167 @@
+// Copyright 2025 Yxa
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+// Persistence service for counters and learned values.
+//
+// Features register a RAM buffer as a record and call yxa_persist_dirty()
+// whenever they change it; nothing touches the EEPROM at that point. The
+// records live in the EEPROM datablock after the tuning block, each in a
+// fixed slot (offsets in yxa.h) as a one-byte id tag followed by the raw
+// bytes. A tag that doesn't match on load (blank datablock, slot given to
+// another record) leaves the feature with its defaults.
+//
+// Dirty records are flushed together, and only when nobody is typing: the
+// board must have seen no input for YXA_PERSIST_IDLE_MS, and at least
+// YXA_PERSIST_INTERVAL_MS must have passed since the last flush, so a
+// counter that ticks all day costs one batch per interval at most. A flash
+// write (and the occasional wear-leveling consolidation) stalls the CPU;
+// the slave also needs the whole board idle (power tier past ACTIVE), since
+// it can't see the master's typing and a stall would cost it link rounds.
+// USB suspend flushes right away.
+//
+// A shadow of the stored bytes is kept in RAM, so a flush compares in
+// memory and writes only records that really changed.
+
+#include "quantum.h"
+#include "yxa.h"
+
+#define PERSIST_MAX_RECORDS 4
+
+typedef struct {
+    uint8_t id;
+    uint8_t size;
+    uint8_t offset;  // Of the tag in the persist area
+    bool dirty;
+    const void *data;
+} persist_record_t;
+
+static persist_record_t records[PERSIST_MAX_RECORDS];
+static uint8_t record_count = 0;
+static uint8_t used = 0;
+static uint8_t stored[YXA_PERSIST_SIZE];  // What the EEPROM holds
+static bool any_dirty = false;
+static uint32_t last_flush = 0;
+static yxa_persist_stats_t persist_stats;
+
+void persist_init(void) {
+    eeconfig_read_kb_datablock(stored, YXA_TUNING_SIZE, sizeof(stored));
+    last_flush = timer_read32();
+}
+
+static persist_record_t *find_record(uint8_t id) {
+    for (uint8_t i = 0; i < record_count; i++) {
+        if (records[i].id == id) {
+            return &records[i];
+        }
+    }
+    return NULL;
+}
+
+bool yxa_persist_register(uint8_t id, uint8_t offset, void *data, uint8_t size) {
+    uint8_t end = offset + 1 + size;
+    if (record_count >= PERSIST_MAX_RECORDS || end > YXA_PERSIST_SIZE) {
+        return false;
+    }
+    for (uint8_t i = 0; i < record_count; i++) {
+        if (offset < records[i].offset + 1 + records[i].size && records[i].offset < end) {
+            return false;
+        }
+    }
+    persist_record_t *record = &records[record_count++];
+    *record = (persist_record_t){.id = id, .size = size, .offset = offset, .data = data};
+    used = MAX(used, end);
+
+    if (stored[record->offset] != id) {
+        return false;
+    }
+    memcpy(data, &stored[record->offset + 1], size);
+    return true;
+}
+
+void yxa_persist_dirty(uint8_t id) {
+    persist_record_t *record = find_record(id);
+    if (record) {
+        record->dirty = true;
+        any_dirty = true;
+    }
+}
+
+bool yxa_persist_pending(uint8_t id) {
+    persist_record_t *record = find_record(id);
+    return record && record->dirty;
+}
+
+static uint8_t count_changed(const uint8_t *a, const uint8_t *b, uint8_t size) {
+    uint8_t changed = 0;
+    for (uint8_t i = 0; i < size; i++) {
+        changed += a[i] != b[i];
+    }
+    return changed;
+}
+
+void yxa_persist_flush(void) {
+    if (!any_dirty) {
+        return;
+    }
+    uint32_t start = yxa_cycles();
+    bool wrote = false;
+
+    for (uint8_t i = 0; i < record_count; i++) {
+        persist_record_t *record = &records[i];
+        if (!record->dirty) {
+            continue;
+        }
+        record->dirty = false;
+
+        uint8_t *slot = &stored[record->offset];
+        uint8_t changed = (slot[0] != record->id) + count_changed(slot + 1, record->data, record->size);
+        if (!changed) {
+            continue;
+        }
+        slot[0] = record->id;
+        memcpy(slot + 1, record->data, record->size);
+        // The driver only programs bytes that differ
+        eeconfig_update_kb_datablock(slot, YXA_TUNING_SIZE + record->offset, 1 + record->size);
+
+        persist_stats.records_written++;
+        persist_stats.bytes_written += changed;
+        wrote = true;
+    }
+    any_dirty = false;
+    last_flush = timer_read32();
+
+    if (wrote) {
+        uint32_t us = (yxa_cycles() - start) / YXA_CYCLES_PER_US;
+        persist_stats.flushes++;
+        persist_stats.flush_us_last = MIN(us, UINT16_MAX);
+        if (persist_stats.flush_us_last > persist_stats.flush_us_max) {
+            persist_stats.flush_us_max = persist_stats.flush_us_last;
+        }
+    }
+}
+
+void persist_task(void) {
+    if (!any_dirty || timer_elapsed32(last_flush) < YXA_PERSIST_INTERVAL_MS) {
+        return;
+    }
+    if (last_input_activity_elapsed() < YXA_PERSIST_IDLE_MS) {
+        return;
+    }
+    if (!is_keyboard_master() && yxa_power_tier() == YXA_POWER_ACTIVE) {
+        return;
+    }
+    yxa_persist_flush();
+}
+
+void yxa_persist_stats_get(yxa_persist_stats_t *stats) {
+    *stats = persist_stats;
+    stats->dirty_records = 0;
+    for (uint8_t i = 0; i < record_count; i++) {
+        stats->dirty_records += records[i].dirty;
+    }
+    stats->bytes_used = used;
+}
+
+void yxa_persist_stats_reset(void) {
+    memset(&persist_stats, 0, sizeof(persist_stats));
+}
@@ -0,0 +1,65 @@
+// Copyright 2025 Yxa
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+// Idle power tiers.
+//
+// The master steps down as input goes quiet, and goes straight to the
+// lowest tier on USB suspend:
+//   YXA_POWER_DIM   after YXA_POWER_DIM_MS: LEDs scaled by YXA_POWER_DIM_SCALE
+//                   (ws2812_dma.c)
+//   YXA_POWER_OFF   after YXA_POWER_OFF_MS: rgb_matrix suspended (RGB_MATRIX_SLEEP)
+//                   and the WS2812 DMA idle after one black frame
+//   YXA_POWER_SLOW  after YXA_POWER_SLOW_MS: the master polls the other half
+//                   once per YXA_POWER_SLOW_POLL_INTERVAL_US (split_sync.c)
+// The tier travels to the slave with the indicator state (yxa.c). A USB
+// wake-up counts as activity, since the host may have been woken by the
+// mouse or a timer with no key pressed here.
+//
+// Keys are never held back: a press is scanned and processed as usual
+// (left-half pins wake the scan loop by EXTI), and the housekeeping pass
+// right after it puts everything back to YXA_POWER_ACTIVE. The local scan
+// never slows down; in YXA_POWER_SLOW only the other half's keys are picked
+// up at the slower poll cadence.
+
+#include "quantum.h"
+#include "yxa.h"
+
+static bool usb_suspended = false;
+static uint32_t wake_time = 0;
+
+void power_task(void) {
+    uint32_t idle = MIN(last_input_activity_elapsed(), timer_elapsed32(wake_time));
+
+    uint8_t tier = YXA_POWER_ACTIVE;
+    if (usb_suspended || idle >= YXA_POWER_SLOW_MS) {
+        tier = YXA_POWER_SLOW;
+    } else if (idle >= YXA_POWER_OFF_MS) {
+        tier = YXA_POWER_OFF;
+    } else if (idle >= YXA_POWER_DIM_MS) {
+        tier = YXA_POWER_DIM;
+    }
+
+    if (tier != yxa_power_tier()) {
+        // Tier first, so the flush rgb_matrix does on suspend already goes out dark
+        yxa_power_tier_set(tier);
+#ifdef RGB_MATRIX_ENABLE
+        // Synced to the slave by QMK's own rgb_matrix transaction
+        rgb_matrix_set_suspend_state(tier >= YXA_POWER_OFF);
+#endif
+    }
+}
+
+// Housekeeping doesn't run while suspended; the suspend loop calls this
+void suspend_power_down_kb(void) {
+    usb_suspended = true;
+    power_task();
+    yxa_persist_flush();
+    suspend_power_down_user();
+}
+
+void suspend_wakeup_init_kb(void) {
+    usb_suspended = false;
+    wake_time = timer_read32();
+    power_task();
+    suspend_wakeup_init_user();
+}
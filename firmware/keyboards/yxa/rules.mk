@@ -1 +1,33 @@
 # Yxa Keyboard Rules
+
+# Port-parallel direct-pin reader (matrix.c)
+CUSTOM_MATRIX = lite
+SRC += matrix.c
+
+# Split matrix exchange with slave-side delta log (split_sync.c)
+SRC += split_sync.c
+
+# Per-key eager-press / deferred-release debounce (debounce.c)
+DEBOUNCE_TYPE = custom
+SRC += debounce.c
+
+# Runtime tuning block in EEPROM, synced to the slave (tuning.c)
+SRC += tuning.c
+
+# Idle-time batched EEPROM writes for counters and learned values (persist.c)
+SRC += persist.c
+
+# Idle power tiers (power.c)
+SRC += power.c
+
+# One-shot DMA WS2812 driver, flushes only changed frames (ws2812_dma.c)
+SRC += ws2812_dma.c
+
+# Full-duplex DMA split transport (serial_dma.c), needs a TRRS cable:
+#   make yxa:miryoku YXA_SPLIT_DMA=yes
+YXA_SPLIT_DMA ?= no
+ifeq ($(strip $(YXA_SPLIT_DMA)), yes)
+    SERIAL_DRIVER = custom
+    SRC += serial_dma.c
+    OPT_DEFS += -DYXA_SPLIT_DMA
+endif
@@ -0,0 +1,298 @@
+// Copyright 2025 Yxa
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+// Full-duplex DMA split transport (SERIAL_DRIVER = custom, YXA_SPLIT_DMA=yes)
+//
+// Replaces QMK's half-duplex usart driver with the ChibiOS UART driver on
+// separate TX/RX pins. Transfers run on DMA and the waiting thread sleeps
+// on a semaphore instead of draining a byte queue, and there is no echo of
+// our own bytes to read back. The wire protocol is QMK's: transaction id,
+// handshake (id ^ HANDSHAKE_MAGIC), initiator buffer, target buffer. Each
+// side arms its receive before it sends, so nothing is lost at turnaround.
+//
+// Needs a TRRS cable with TX of each half wired to RX of the other; the
+// stock TRS build keeps the half-duplex driver.
+//
+// The master can also benchmark the link (yxa_split_bench): both halves
+// switch to each rate in turn and the round trip of every transaction is
+// timed with the cycle counter.
+
+#include "quantum.h"
+#include "serial.h"
+#include "transactions.h"
+#include "yxa.h"
+
+#ifndef SERIAL_DMA_DRIVER
+#    define SERIAL_DMA_DRIVER UARTD1
+#endif
+#ifndef SERIAL_USART_TX_PIN
+#    define SERIAL_USART_TX_PIN A9
+#endif
+#ifndef SERIAL_USART_RX_PIN
+#    define SERIAL_USART_RX_PIN A10
+#endif
+#ifndef SERIAL_USART_TX_PAL_MODE
+#    define SERIAL_USART_TX_PAL_MODE 7
+#endif
+#ifndef SERIAL_USART_RX_PAL_MODE
+#    define SERIAL_USART_RX_PAL_MODE 7
+#endif
+#ifndef SERIAL_USART_SPEED
+#    define SERIAL_USART_SPEED 921600
+#endif
+#ifndef SERIAL_USART_TIMEOUT
+#    define SERIAL_USART_TIMEOUT 20
+#endif
+
+#define HANDSHAKE_MAGIC 7
+
+// Rates tried by the benchmark, all within USART1's 3 Mbaud on a 48 MHz APB2
+static const uint32_t bench_speeds[YXA_SPLIT_BENCH_RATES] = {460800, 921600, 1500000, 2000000};
+
+#define BENCH_TRANSACTIONS 32
+#define BENCH_SLAVE_REVERT_MS 200
+
+static UARTConfig uart_config;
+static binary_semaphore_t rx_done;
+static binary_semaphore_t tx_done;
+static volatile bool rx_failed;
+
+// Round-trip timing of completed transactions (master)
+static uint32_t rtt_cycles_total;
+static uint32_t rtt_cycles_max;
+static uint16_t rtt_count;
+static uint8_t rtt_errors;
+
+// Slave: speed to switch to once the current transaction is answered
+static uint32_t pending_speed = 0;
+
+static void rx_end(UARTDriver *uartp) {
+    (void)uartp;
+    chSysLockFromISR();
+    chBSemSignalI(&rx_done);
+    chSysUnlockFromISR();
+}
+
+static void tx_end(UARTDriver *uartp) {
+    (void)uartp;
+    chSysLockFromISR();
+    chBSemSignalI(&tx_done);
+    chSysUnlockFromISR();
+}
+
+static void rx_error(UARTDriver *uartp, uartflags_t e) {
+    (void)uartp;
+    (void)e;
+    rx_failed = true;
+}
+
+static void uart_begin(uint32_t speed) {
+    uart_config = (UARTConfig){
+        .txend2_cb = tx_end,
+        .rxend_cb = rx_end,
+        .rxerr_cb = rx_error,
+        .speed = speed,
+    };
+    chBSemObjectInit(&rx_done, true);
+    chBSemObjectInit(&tx_done, true);
+    uartStart(&SERIAL_DMA_DRIVER, &uart_config);
+}
+
+static void uart_restart(uint32_t speed) {
+    uartStop(&SERIAL_DMA_DRIVER);
+    uart_begin(speed);
+}
+
+static void arm_receive(void *buf, size_t len) {
+    chBSemReset(&rx_done, true);
+    rx_failed = false;
+    uartStartReceive(&SERIAL_DMA_DRIVER, len, buf);
+}
+
+static bool wait_receive(sysinterval_t timeout) {
+    if (chBSemWaitTimeout(&rx_done, timeout) != MSG_OK) {
+        uartStopReceive(&SERIAL_DMA_DRIVER);
+        return false;
+    }
+    return !rx_failed;
+}
+
+static bool send(const void *buf, size_t len) {
+    chBSemReset(&tx_done, true);
+    uartStartSend(&SERIAL_DMA_DRIVER, len, buf);
+    if (chBSemWaitTimeout(&tx_done, TIME_MS2I(SERIAL_USART_TIMEOUT)) != MSG_OK) {
+        uartStopSend(&SERIAL_DMA_DRIVER);
+        return false;
+    }
+    return true;
+}
+
+static void pins_init(void) {
+    palSetLineMode(SERIAL_USART_TX_PIN, PAL_MODE_ALTERNATE(SERIAL_USART_TX_PAL_MODE) | PAL_OUTPUT_TYPE_PUSHPULL | PAL_OUTPUT_SPEED_HIGHEST);
+    palSetLineMode(SERIAL_USART_RX_PIN, PAL_MODE_ALTERNATE(SERIAL_USART_RX_PAL_MODE) | PAL_PUPDR_PULLUP);
+}
+
+// Target
+
+static bool react_to_transaction(uint8_t id) {
+    if (id >= NUM_TOTAL_TRANSACTIONS) {
+        return false;
+    }
+    split_transaction_desc_t *trans = &split_transaction_table[id];
+
+    // Arm for the initiator's buffer before the handshake goes out
+    if (trans->initiator2target_buffer_size) {
+        arm_receive(split_trans_initiator2target_buffer(trans), trans->initiator2target_buffer_size);
+    }
+    uint8_t shake = id ^ HANDSHAKE_MAGIC;
+    if (!send(&shake, sizeof(shake))) {
+        return false;
+    }
+    if (trans->initiator2target_buffer_size && !wait_receive(TIME_MS2I(SERIAL_USART_TIMEOUT))) {
+        return false;
+    }
+
+    if (trans->slave_callback) {
+        trans->slave_callback(trans->initiator2target_buffer_size, split_trans_initiator2target_buffer(trans), trans->target2initiator_buffer_size, split_trans_target2initiator_buffer(trans));
+    }
+
+    if (trans->target2initiator_buffer_size) {
+        return send(split_trans_target2initiator_buffer(trans), trans->target2initiator_buffer_size);
+    }
+    return true;
+}
+
+static THD_WORKING_AREA(waSlaveThread, 1024);
+static THD_FUNCTION(SlaveThread, arg) {
+    (void)arg;
+    chRegSetThreadName("split_dma_slave");
+
+    uint32_t speed = SERIAL_USART_SPEED;
+    while (true) {
+        uint8_t id;
+        arm_receive(&id, sizeof(id));
+
+        // Off the default speed (benchmark), fall back if the master goes quiet
+        sysinterval_t timeout = speed == SERIAL_USART_SPEED ? TIME_INFINITE : TIME_MS2I(BENCH_SLAVE_REVERT_MS);
+        if (!wait_receive(timeout)) {
+            if (speed != SERIAL_USART_SPEED) {
+                speed = SERIAL_USART_SPEED;
+                uart_restart(speed);
+            }
+            continue;
+        }
+
+        react_to_transaction(id);
+
+        if (pending_speed) {
+            speed = pending_speed;
+            pending_speed = 0;
+            uart_restart(speed);
+        }
+    }
+}
+
+void soft_serial_target_init(void) {
+    pins_init();
+    uart_begin(SERIAL_USART_SPEED);
+    chThdCreateStatic(waSlaveThread, sizeof(waSlaveThread), HIGHPRIO, SlaveThread, NULL);
+}
+
+// Initiator
+
+void soft_serial_initiator_init(void) {
+    pins_init();
+    uart_begin(SERIAL_USART_SPEED);
+}
+
+static bool initiate_transaction(uint8_t id) {
+    split_transaction_desc_t *trans = &split_transaction_table[id];
+
+    uint8_t shake = 0xFF;
+    arm_receive(&shake, sizeof(shake));
+    if (!send(&id, sizeof(id)) || !wait_receive(TIME_MS2I(SERIAL_USART_TIMEOUT)) || shake != (id ^ HANDSHAKE_MAGIC)) {
+        return false;
+    }
+
+    // Arm for the target's buffer before ours goes out
+    if (trans->target2initiator_buffer_size) {
+        arm_receive(split_trans_target2initiator_buffer(trans), trans->target2initiator_buffer_size);
+    }
+    if (trans->initiator2target_buffer_size && !send(split_trans_initiator2target_buffer(trans), trans->initiator2target_buffer_size)) {
+        if (trans->target2initiator_buffer_size) {
+            uartStopReceive(&SERIAL_DMA_DRIVER);
+        }
+        return false;
+    }
+    if (trans->target2initiator_buffer_size && !wait_receive(TIME_MS2I(SERIAL_USART_TIMEOUT))) {
+        return false;
+    }
+    return true;
+}
+
+bool soft_serial_transaction(int index) {
+    uint32_t start = yxa_cycles();
+    if (!initiate_transaction((uint8_t)index)) {
+        rtt_errors = MIN(rtt_errors + 1, UINT8_MAX);
+        return false;
+    }
+
+    uint32_t cycles = yxa_cycles() - start;
+    rtt_cycles_total += cycles;
+    rtt_count++;
+    if (cycles > rtt_cycles_max) {
+        rtt_cycles_max = cycles;
+    }
+    return true;
+}
+
+// Benchmark
+
+// Slave side of YXA_SYNC_BENCH: in = speed to switch to, 0 = ping
+static void bench_slave_handler(uint8_t in_buflen, const void *in_data, uint8_t out_buflen, void *out_data) {
+    uint32_t speed;
+    memcpy(&speed, in_data, sizeof(speed));
+    if (speed) {
+        pending_speed = speed;
+    }
+}
+
+static bool bench_switch(uint32_t speed) {
+    bool ok = transaction_rpc_send(YXA_SYNC_BENCH, sizeof(speed), &speed);
+    // The slave switches once it has answered; give it a moment
+    wait_ms(1);
+    uart_restart(speed);
+    return ok;
+}
+
+void yxa_split_bench(yxa_split_bench_t results[YXA_SPLIT_BENCH_RATES]) {
+    for (uint8_t i = 0; i < YXA_SPLIT_BENCH_RATES; i++) {
+        yxa_split_bench_t *result = &results[i];
+        result->speed = bench_speeds[i];
+
+        rtt_cycles_total = 0;
+        rtt_cycles_max = 0;
+        rtt_count = 0;
+        rtt_errors = 0;
+
+        if (bench_switch(bench_speeds[i])) {
+            uint32_t ping = 0;
+            for (uint8_t n = 0; n < BENCH_TRANSACTIONS; n++) {
+                transaction_rpc_send(YXA_SYNC_BENCH, sizeof(ping), &ping);
+            }
+        } else {
+            rtt_errors = UINT8_MAX;
+        }
+
+        result->rtt_us_avg = rtt_count ? rtt_cycles_total / rtt_count / YXA_CYCLES_PER_US : 0;
+        result->rtt_us_max = MIN(rtt_cycles_max / YXA_CYCLES_PER_US, UINT16_MAX);
+        result->errors = rtt_errors;
+    }
+
+    // Back to normal; if the slave misses this it reverts on its own
+    bench_switch(SERIAL_USART_SPEED);
+}
+
+void serial_dma_init(void) {
+    transaction_register_rpc(YXA_SYNC_BENCH, bench_slave_handler);
+}
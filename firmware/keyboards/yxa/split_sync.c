@@ -0,0 +1,402 @@
+// Copyright 2025 Yxa
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+// Split matrix exchange.
+//
+// The slave logs every debounced change of its half as a sequence-numbered
+// delta with a slave-side (sync timer) timestamp. QMK's transport still
+// carries everything else, but the slave hands its matrix exchange a beacon
+// instead of its rows: the newest sequence number and that change, which
+// fit the same four bytes. So the 1-byte checksum read stays the only cost
+// of a quiet poll, and a single change costs what QMK's matrix read costs.
+// Only when the master finds more than one change since the last sequence
+// number it applied (or has no baseline yet: boot, reconnect) does it pull
+// the log along with the half's full rows (YXA_SYNC_DELTA). The rows are
+// authoritative; if the log has wrapped, they are used as they are.
+//
+// The master also stops polling the link on every scan: transport runs at
+// most once per YXA_SPLIT_POLL_INTERVAL_US, or YXA_POWER_SLOW_POLL_INTERVAL_US
+// in the slowest power tier (or right away for a local change, see below),
+// so local scans in between don't sit blocked on the USART.
+//
+// Right-hand changes reach the master a transport round after they happen,
+// so the master doesn't hand changes to QMK as it learns of them. Both
+// halves' changes go into an order queue stamped with when they really
+// happened (sync timer, shared by both halves), and are presented to
+// matrix_task one per scan, earliest first. A local change polls the other
+// half in the same scan, so an earlier right-hand change still has the
+// chance to arrive first without the local one waiting for the next
+// regular poll. The presented change's timestamp is then written into the
+// key event's time (split_sync_stamp), so tap-hold sees true cross-hand
+// timing.
+//
+// Link supervision sits on top of QMK's error counting. Transport goes
+// through transport_master_if_connected(), so after SPLIT_MAX_CONNECTION_ERRORS
+// failed rounds is_transport_connected() drops (which also holds off split
+// RPCs) and a reconnect is only tried once per SPLIT_CONNECTION_CHECK_TIMEOUT,
+// each failed try blocking for SERIAL_USART_TIMEOUT. Every successful poll
+// is a heartbeat; with none for YXA_SPLIT_LINK_TIMEOUT_MS the link is
+// declared down, the other half's keys are released, and the serial driver
+// is re-initialised. The outage (last heartbeat to first good poll) is
+// recorded in the split stats.
+
+#include "quantum.h"
+#include "matrix.h"
+#include "split_util.h"
+#include "transactions.h"
+#include "transport.h"
+#include "serial.h"
+#include "yxa.h"
+
+extern matrix_row_t matrix[MATRIX_ROWS];
+extern uint8_t thisHand, thatHand;
+
+#define DELTA_LOG_SIZE 8
+#define DELTA_GAP 0xFF  // Record count when the requested seq fell off the log
+
+// Packed key: bit 7 pressed, bits 4-6 row within the half, bits 0-3 column
+typedef struct __attribute__((packed)) {
+    uint8_t key;
+    uint16_t time;
+} delta_event_t;
+
+typedef struct __attribute__((packed)) {
+    uint8_t seq;                        // Sequence number of the newest logged event
+    uint8_t count;                      // Events that follow, oldest first, or DELTA_GAP
+    matrix_row_t rows[ROWS_PER_HAND];  // The half as of seq
+    delta_event_t events[DELTA_LOG_SIZE];
+} delta_record_t;
+
+_Static_assert(sizeof(delta_record_t) <= RPC_S2M_BUFFER_SIZE, "Delta record exceeds split RPC buffer");
+
+// What the slave's matrix exchange carries in place of its rows
+typedef union {
+    matrix_row_t rows[ROWS_PER_HAND];
+    struct __attribute__((packed)) {
+        uint8_t seq;
+        delta_event_t event;  // The change that made seq
+    };
+} delta_beacon_t;
+
+_Static_assert(sizeof(delta_beacon_t) == sizeof(matrix_row_t) * ROWS_PER_HAND, "Delta beacon doesn't fit the slave matrix exchange");
+
+// Slave: ring of the last DELTA_LOG_SIZE changes, slot = seq % size
+static delta_event_t delta_log[DELTA_LOG_SIZE];
+static matrix_row_t delta_rows[ROWS_PER_HAND];
+static volatile uint8_t delta_seq = 0;
+static delta_beacon_t beacon;
+
+// Master: one queued change of either half, row is the global matrix row
+typedef struct {
+    uint8_t row;
+    uint8_t col;
+    bool pressed;
+    bool local;
+    uint8_t poll_mark;  // poll_seq when a local change was queued
+    uint16_t time;
+} order_event_t;
+
+#define ORDER_QUEUE_SIZE 16
+
+static order_event_t order_queue[ORDER_QUEUE_SIZE];
+static uint8_t order_count = 0;
+static uint8_t poll_seq = 0;
+static bool link_up = false;
+static matrix_row_t remote_rows[ROWS_PER_HAND];  // Slave half as last synced
+
+// Change presented by the last scan, for stamping its key event
+static order_event_t presented;
+static bool presented_valid = false;
+
+// Master
+static uint8_t applied_seq = 0;
+static bool seq_known = false;
+static uint32_t last_poll = 0;
+static uint32_t last_heartbeat = 0;  // timer_read32() of the last good poll
+static bool link_lost = false;       // Down after having been up (not boot)
+static yxa_split_stats_t split_stats;
+static uint32_t polls_this_second = 0;
+static uint32_t transport_cycles_total = 0;
+static uint16_t second_start = 0;
+
+static void delta_sync_slave_handler(uint8_t in_buflen, const void *in_data, uint8_t out_buflen, void *out_data) {
+    uint8_t since = *(const uint8_t *)in_data;
+    delta_record_t *record = out_data;
+
+    // Rows that match the seq, even if the scan loop is mid-update
+    chSysLock();
+    uint8_t seq = delta_seq;
+    memcpy(record->rows, delta_rows, sizeof(delta_rows));
+    chSysUnlock();
+
+    uint8_t count = seq - since;
+    record->seq = seq;
+    if (count > DELTA_LOG_SIZE) {
+        record->count = DELTA_GAP;
+        return;
+    }
+    record->count = count;
+    for (uint8_t i = 0; i < count; i++) {
+        record->events[i] = delta_log[(uint8_t)(since + 1 + i) % DELTA_LOG_SIZE];
+    }
+}
+
+void split_sync_init(void) {
+    transaction_register_rpc(YXA_SYNC_DELTA, delta_sync_slave_handler);
+}
+
+// Slave: log the changes debounce just made to this half
+void split_sync_log(const matrix_row_t before[], const matrix_row_t after[]) {
+    uint16_t now = sync_timer_read();
+    for (uint8_t row = 0; row < ROWS_PER_HAND; row++) {
+        matrix_row_t delta = before[row] ^ after[row];
+        for (uint8_t col = 0; delta; col++, delta >>= 1) {
+            if (!(delta & 1)) {
+                continue;
+            }
+            matrix_row_t mask = (matrix_row_t)1 << col;
+            bool pressed = after[row] & mask;
+            uint8_t seq = delta_seq + 1;
+            delta_event_t event = {
+                .key = (pressed ? 0x80 : 0) | (row << 4) | col,
+                .time = now,
+            };
+
+            // The RPC handler runs on the serial thread and must see the
+            // slot, rows and seq change together
+            chSysLock();
+            delta_log[seq % DELTA_LOG_SIZE] = event;
+            delta_rows[row] = pressed ? delta_rows[row] | mask : delta_rows[row] & ~mask;
+            delta_seq = seq;
+            chSysUnlock();
+
+            beacon.seq = seq;
+            beacon.event = event;
+        }
+    }
+}
+
+// Age of a sync-timer timestamp; stamps slightly ahead of us count as now
+static uint16_t stamp_age(uint16_t time, uint16_t now) {
+    int16_t age = (int16_t)(now - time);
+    return age < 0 ? 0 : age;
+}
+
+static void present(uint8_t index) {
+    order_event_t *ev = &order_queue[index];
+    matrix_row_t mask = (matrix_row_t)1 << ev->col;
+    if (ev->pressed) {
+        matrix[ev->row] |= mask;
+    } else {
+        matrix[ev->row] &= ~mask;
+    }
+    presented = *ev;
+
+    order_count--;
+    for (uint8_t i = index; i < order_count; i++) {
+        order_queue[i] = order_queue[i + 1];
+    }
+}
+
+// Present the earliest queued change, unless it's a local one still waiting
+// for the other half to be polled
+static bool present_next(void) {
+    if (order_count == 0) {
+        return false;
+    }
+
+    uint16_t now = sync_timer_read();
+    uint8_t next = 0;
+    for (uint8_t i = 1; i < order_count; i++) {
+        if (stamp_age(order_queue[i].time, now) > stamp_age(order_queue[next].time, now)) {
+            next = i;
+        }
+    }
+
+    if (order_queue[next].local && order_queue[next].poll_mark == poll_seq && link_up) {
+        return false;
+    }
+    present(next);
+    presented_valid = true;
+    return true;
+}
+
+static void order_push(uint8_t row, uint8_t col, bool pressed, bool local, uint16_t time) {
+    // Full: push out the oldest now, ordering lost for that one
+    if (order_count >= ORDER_QUEUE_SIZE) {
+        present(0);
+        presented_valid = false;
+    }
+    order_queue[order_count++] = (order_event_t){
+        .row = row,
+        .col = col,
+        .pressed = pressed,
+        .local = local,
+        .poll_mark = poll_seq,
+        .time = time,
+    };
+}
+
+// Queue every difference between two views of one half
+static void order_push_diff(uint8_t row_offset, const matrix_row_t before[], const matrix_row_t after[], bool local, uint16_t time) {
+    for (uint8_t row = 0; row < ROWS_PER_HAND; row++) {
+        matrix_row_t delta = before[row] ^ after[row];
+        for (uint8_t col = 0; delta; col++, delta >>= 1) {
+            if (delta & 1) {
+                order_push(row_offset + row, col, after[row] & ((matrix_row_t)1 << col), local, time);
+            }
+        }
+    }
+}
+
+// Master: apply one slave change to remote_rows and queue it with its
+// slave timestamp
+static void apply_delta(const delta_event_t *event) {
+    uint8_t key = event->key;
+    uint8_t row = (key >> 4) & 0x07;
+    uint8_t col = key & 0x0F;
+    matrix_row_t mask = (matrix_row_t)1 << col;
+    bool pressed = key & 0x80;
+
+    if (!(remote_rows[row] & mask) != !pressed) {
+        remote_rows[row] ^= mask;
+        order_push(thatHand + row, col, pressed, false, event->time);
+    }
+    split_stats.delta_events++;
+}
+
+// Master: bring remote_rows up to the beacon's seq. One new change comes
+// with the beacon; anything else means pulling the log and the full rows.
+static void pull_deltas(const delta_beacon_t *polled) {
+    if (seq_known && polled->seq == applied_seq) {
+        return;
+    }
+    if (seq_known && polled->seq == (uint8_t)(applied_seq + 1)) {
+        apply_delta(&polled->event);
+        applied_seq = polled->seq;
+        return;
+    }
+
+    delta_record_t record;
+    if (!transaction_rpc_exec(YXA_SYNC_DELTA, sizeof(applied_seq), &applied_seq, sizeof(record), &record)) {
+        return;  // Next poll tries again
+    }
+    if (seq_known && record.count != DELTA_GAP) {
+        for (uint8_t i = 0; i < record.count; i++) {
+            apply_delta(&record.events[i]);
+        }
+    }
+
+    // Whatever the log couldn't account for comes from the rows
+    if (memcmp(remote_rows, record.rows, sizeof(remote_rows)) != 0) {
+        order_push_diff(thatHand, remote_rows, record.rows, false, sync_timer_read());
+        memcpy(remote_rows, record.rows, sizeof(remote_rows));
+        split_stats.full_refreshes++;
+    }
+    applied_seq = record.seq;
+    seq_known = true;
+}
+
+bool split_sync_master(const matrix_row_t before[], const matrix_row_t after[], bool local_changed) {
+    presented_valid = false;
+
+    if (local_changed) {
+        order_push_diff(thisHand, before, after, true, sync_timer_read());
+    }
+
+    uint32_t now = yxa_cycles();
+    uint32_t interval_us = yxa_power_tier() == YXA_POWER_SLOW ? YXA_POWER_SLOW_POLL_INTERVAL_US : YXA_SPLIT_POLL_INTERVAL_US;
+    // A local change is only presented once the other half has been polled
+    // after it; do that now rather than hold it for the interval
+    bool order_poll = local_changed && link_up;
+    if (order_poll || now - last_poll >= interval_us * YXA_CYCLES_PER_US) {
+        last_poll = now;
+        delta_beacon_t polled = {0};
+        // Otherwise QMK is backing off and may not even try
+        bool attempted = is_transport_connected();
+
+        if (transport_master_if_connected(matrix + thisHand, polled.rows)) {
+            pull_deltas(&polled);
+            if (link_lost) {
+                uint32_t outage = timer_elapsed32(last_heartbeat);
+                split_stats.recovery_ms_last = MIN(outage, UINT16_MAX);
+                if (split_stats.recovery_ms_last > split_stats.recovery_ms_max) {
+                    split_stats.recovery_ms_max = split_stats.recovery_ms_last;
+                }
+                link_lost = false;
+            }
+            link_up = true;
+            last_heartbeat = timer_read32();
+        } else {
+            if (attempted) {
+                split_stats.failed_polls++;
+            }
+            if (link_up && timer_elapsed32(last_heartbeat) >= YXA_SPLIT_LINK_TIMEOUT_MS) {
+                // Other half gone: release everything it was holding
+                matrix_row_t released[ROWS_PER_HAND] = {0};
+                order_push_diff(thatHand, remote_rows, released, false, sync_timer_read());
+                memset(remote_rows, 0, sizeof(remote_rows));
+                seq_known = false;
+                link_up = false;
+                link_lost = true;
+                split_stats.link_losses++;
+                soft_serial_initiator_init();
+            }
+        }
+        poll_seq++;
+
+        uint32_t cycles = yxa_cycles() - now;
+        transport_cycles_total += cycles;
+        polls_this_second++;
+        if (cycles > split_stats.transport_cycles_max) {
+            split_stats.transport_cycles_max = MIN(cycles, UINT16_MAX);
+        }
+    }
+
+    if (timer_elapsed(second_start) >= 1000) {
+        split_stats.poll_rate = polls_this_second;
+        split_stats.transport_cycles_avg = polls_this_second ? MIN(transport_cycles_total / polls_this_second, UINT16_MAX) : 0;
+        polls_this_second = 0;
+        transport_cycles_total = 0;
+        second_start = timer_read();
+    }
+
+    bool changed = present_next();
+    matrix_scan_quantum();
+    return changed;
+}
+
+bool split_sync_link_up(void) {
+    return link_up;
+}
+
+// Give the key event for the change just presented its true time
+void split_sync_stamp(keyrecord_t *record) {
+    if (!presented_valid || record->event.key.row != presented.row ||
+        record->event.key.col != presented.col || record->event.pressed != presented.pressed) {
+        return;
+    }
+    presented_valid = false;
+
+    uint16_t now = sync_timer_read();
+    record->event.time = (uint16_t)(now - stamp_age(presented.time, now)) | 1;
+}
+
+void split_sync_slave(matrix_row_t master_rows[]) {
+    transport_slave(master_rows, beacon.rows);
+    matrix_slave_scan_kb();
+}
+
+void yxa_split_stats_get(yxa_split_stats_t *stats) {
+    *stats = split_stats;
+}
+
+void yxa_split_stats_reset(void) {
+    split_stats.transport_cycles_max = 0;
+    split_stats.delta_events = 0;
+    split_stats.full_refreshes = 0;
+    split_stats.failed_polls = 0;
+    split_stats.link_losses = 0;
+    split_stats.recovery_ms_last = 0;
+    split_stats.recovery_ms_max = 0;
+}
@@ -0,0 +1,127 @@
+// Copyright 2025 Yxa
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+// Runtime tuning block.
+//
+// Timing and feel settings that used to need a reflash (of both halves)
+// live in the keyboard's EEPROM datablock, which sits in the wear-leveled
+// flash backing store. Each half loads its own copy at boot; a block with
+// the wrong version (blank or from an older layout) or any field out of
+// range is replaced by the config.h defaults; the keymap checks its own
+// fields in yxa_tuning_valid_user(). Changes from the host land on the
+// master, which pushes the block to the slave once per change (and again
+// when the link comes back, in case the slave rebooted). Both halves apply
+// a change at once and save it from the next housekeeping pass, so either
+// half can be the one on USB next time and the slave's RPC handler never
+// waits on a flash write.
+//
+// Only the debounce is applied here. Everything else is read by the keymap
+// when it is used (tap-hold callbacks, RGB frames, mouse keys).
+
+#include "quantum.h"
+#include "transactions.h"
+#include "yxa.h"
+
+#ifndef TAPPING_TERM_MOD_TAP
+#    define TAPPING_TERM_MOD_TAP TAPPING_TERM
+#endif
+#ifndef TAPPING_TERM_LAYER
+#    define TAPPING_TERM_LAYER TAPPING_TERM
+#endif
+#ifndef QUICK_TAP_TERM
+#    define QUICK_TAP_TERM TAPPING_TERM
+#endif
+#ifndef RGB_LAYER_BRIGHTNESS
+#    define RGB_LAYER_BRIGHTNESS 255
+#endif
+
+static yxa_tuning_t tuning;
+static bool tuning_dirty = false;    // Not yet sent to the slave
+static bool tuning_unsaved = false;  // Not yet written to EEPROM
+
+void yxa_tuning_defaults(yxa_tuning_t *out) {
+    *out = (yxa_tuning_t){
+        .version = YXA_TUNING_VERSION,
+        .debounce = DEBOUNCE,
+        .tapping_term = TAPPING_TERM,
+        .tapping_term_mod_tap = TAPPING_TERM_MOD_TAP,
+        .tapping_term_layer = TAPPING_TERM_LAYER,
+        .quick_tap_term = QUICK_TAP_TERM,
+        .rgb_brightness = RGB_LAYER_BRIGHTNESS,
+        .mouse_profile = 1,
+        .mouse_speed = 100,
+        .wheel_speed = 100,
+    };
+}
+
+__attribute__((weak)) bool yxa_tuning_valid_user(const yxa_tuning_t *block) {
+    return true;
+}
+
+static bool tuning_valid(const yxa_tuning_t *block) {
+    return block->version == YXA_TUNING_VERSION && block->debounce >= 1 && block->debounce <= YXA_CHATTER_DEBOUNCE_MAX && yxa_tuning_valid_user(block);
+}
+
+static void tuning_apply(const yxa_tuning_t *block) {
+    if (memcmp(&tuning, block, sizeof(tuning)) != 0) {
+        tuning_unsaved = true;
+    }
+    tuning = *block;
+    yxa_debounce_set(tuning.debounce);
+}
+
+const yxa_tuning_t *yxa_tuning(void) {
+    return &tuning;
+}
+
+bool yxa_tuning_set(const yxa_tuning_t *block) {
+    if (!tuning_valid(block)) {
+        return false;
+    }
+    if (memcmp(&tuning, block, sizeof(tuning)) != 0) {
+        tuning_apply(block);
+        tuning_dirty = true;
+    }
+    return true;
+}
+
+static void tuning_sync_slave_handler(uint8_t in_buflen, const void *in_data, uint8_t out_buflen, void *out_data) {
+    yxa_tuning_t block;
+    memcpy(&block, in_data, sizeof(block));
+    if (tuning_valid(&block)) {
+        tuning_apply(&block);
+    }
+}
+
+void tuning_task(void) {
+    if (tuning_unsaved) {
+        // Only bytes that differ are written
+        eeconfig_update_kb_datablock(&tuning, 0, sizeof(tuning));
+        tuning_unsaved = false;
+    }
+    if (!is_keyboard_master()) {
+        return;
+    }
+
+    static bool was_connected = false;
+    bool connected = split_sync_link_up();
+    if (connected && !was_connected) {
+        tuning_dirty = true;
+    }
+    was_connected = connected;
+
+    if (tuning_dirty && connected && transaction_rpc_send(YXA_SYNC_TUNING, sizeof(tuning), &tuning)) {
+        tuning_dirty = false;
+    }
+}
+
+void tuning_init(void) {
+    yxa_tuning_t block;
+    eeconfig_read_kb_datablock(&block, 0, sizeof(block));
+    if (!tuning_valid(&block)) {
+        yxa_tuning_defaults(&block);
+    }
+    // tuning is still zeroed, so a fresh or replaced block gets saved
+    tuning_apply(&block);
+    transaction_register_rpc(YXA_SYNC_TUNING, tuning_sync_slave_handler);
+}
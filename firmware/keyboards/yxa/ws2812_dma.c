@@ -0,0 +1,217 @@
+// Copyright 2025 Yxa
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+// WS2812 driver: TIM3 PWM fed by one-shot DMA (WS2812_DRIVER = custom)
+//
+// QMK's PWM driver runs its DMA stream in circular mode, so the whole frame
+// is clocked out to the LEDs continuously, competing with everything else
+// for the bus, even when the layer colors haven't changed for hours. Here
+// the stream runs once per flush, and only when the colors differ from the
+// last frame sent. With CCR preload the line idles low after the final
+// zero-duty slot, which doubles as the latch.
+//
+// Each frame is also held to a current budget before it goes out: the sum
+// of all channel values estimates the LEDs' draw, and a frame over
+// YXA_RGB_CURRENT_LIMIT_MA is scaled down uniformly, so colors keep their
+// hue. Both halves run off the same USB port, so each gets half the limit.
+// WS2812_LED_COUNT is the whole board's; each half only drives (and clocks
+// out) its own share from RGB_MATRIX_SPLIT.
+//
+// In the YXA_POWER_DIM tier (power.c) frames go out at YXA_POWER_DIM_SCALE.
+// From YXA_POWER_OFF on, one black frame goes out and the DMA then stays
+// idle until the tier drops back, whatever rgb_matrix keeps flushing.
+//
+// Timing and pin settings are the same as QMK's PWM driver.
+
+#include "quantum.h"
+#include "ws2812.h"
+#include "yxa.h"
+
+#ifndef WS2812_PWM_CHANNEL
+#    define WS2812_PWM_CHANNEL 2
+#endif
+#ifndef WS2812_PWM_PAL_MODE
+#    define WS2812_PWM_PAL_MODE 2
+#endif
+
+#define WS2812_PWM_FREQUENCY (STM32_SYSCLK / 2)
+#define WS2812_PWM_PERIOD (WS2812_PWM_FREQUENCY / (1000000000 / WS2812_TIMING))
+#define WS2812_DUTYCYCLE_0 (WS2812_PWM_FREQUENCY / (1000000000 / WS2812_T0H))
+#define WS2812_DUTYCYCLE_1 (WS2812_PWM_FREQUENCY / (1000000000 / WS2812_T1H))
+
+// Full-on draw of one color channel, and idle draw per LED (mA)
+#ifndef YXA_RGB_CHANNEL_MA
+#    define YXA_RGB_CHANNEL_MA 20
+#endif
+#ifndef YXA_RGB_IDLE_MA
+#    define YXA_RGB_IDLE_MA 1
+#endif
+
+// This half's channel-sum budget for n LEDs: (limit - idle draw) in units
+// of 1/255 of a channel's current
+#ifdef YXA_RGB_CURRENT_LIMIT_MA
+#    define RGB_SUM_LIMIT(n) ((YXA_RGB_CURRENT_LIMIT_MA / 2 - YXA_RGB_IDLE_MA * (n)) * 255UL / YXA_RGB_CHANNEL_MA)
+_Static_assert(YXA_RGB_CURRENT_LIMIT_MA / 2 > YXA_RGB_IDLE_MA * WS2812_LED_COUNT, "RGB current limit below the LEDs' idle draw");
+#endif
+
+#define WS2812_COLOR_BITS (WS2812_LED_COUNT * 24)
+#define WS2812_TAIL_BITS 2  // Zero-duty slots that leave the line low
+#define WS2812_BIT_N (WS2812_COLOR_BITS + WS2812_TAIL_BITS)
+
+static uint8_t led_count = WS2812_LED_COUNT;  // This half's LEDs
+static rgb_t leds[WS2812_LED_COUNT];
+static rgb_t sent[WS2812_LED_COUNT];  // Last frame handed to the DMA
+static uint8_t sent_tier = YXA_POWER_ACTIVE;
+static uint16_t bit_buffer[WS2812_BIT_N];
+static yxa_rgb_stats_t rgb_stats;
+
+static void write_byte(uint16_t *bits, uint8_t value) {
+    for (uint8_t bit = 0; bit < 8; bit++) {
+        bits[bit] = (value & (0x80 >> bit)) ? WS2812_DUTYCYCLE_1 : WS2812_DUTYCYCLE_0;
+    }
+}
+
+// Estimate the frame's draw; returns the 8.8 factor that keeps it within
+// budget (256 = unscaled)
+static uint16_t frame_scale(void) {
+    uint32_t sum = 0;
+    for (uint16_t i = 0; i < led_count; i++) {
+        sum += leds[i].r + leds[i].g + leds[i].b;
+    }
+
+    uint16_t ma = sum * YXA_RGB_CHANNEL_MA / 255 + YXA_RGB_IDLE_MA * led_count;
+    rgb_stats.frame_ma_last = ma;
+    if (ma > rgb_stats.frame_ma_max) {
+        rgb_stats.frame_ma_max = ma;
+    }
+
+    uint16_t scale = 256;
+#ifdef YXA_RGB_CURRENT_LIMIT_MA
+    uint32_t limit = RGB_SUM_LIMIT(led_count);
+    if (sum > limit) {
+        rgb_stats.scaled_frames++;
+        scale = limit * 256 / sum;
+    }
+#endif
+    if (sent_tier >= YXA_POWER_OFF) {
+        scale = 0;
+    } else if (sent_tier == YXA_POWER_DIM) {
+        scale = scale * YXA_POWER_DIM_SCALE >> 8;
+    }
+    return scale;
+}
+
+static void encode_frame(uint16_t scale) {
+    for (uint16_t i = 0; i < led_count; i++) {
+        uint16_t *bits = &bit_buffer[i * 24];
+        uint8_t r = leds[i].r * scale >> 8;
+        uint8_t g = leds[i].g * scale >> 8;
+        uint8_t b = leds[i].b * scale >> 8;
+#if (WS2812_BYTE_ORDER == WS2812_BYTE_ORDER_RGB)
+        write_byte(bits, r);
+        write_byte(bits + 8, g);
+        write_byte(bits + 16, b);
+#elif (WS2812_BYTE_ORDER == WS2812_BYTE_ORDER_BGR)
+        write_byte(bits, b);
+        write_byte(bits + 8, g);
+        write_byte(bits + 16, r);
+#else
+        write_byte(bits, g);
+        write_byte(bits + 8, r);
+        write_byte(bits + 16, b);
+#endif
+    }
+}
+
+static bool transfer_busy(void) {
+    return WS2812_DMA_STREAM->stream->CR & STM32_DMA_CR_EN;
+}
+
+static void start_transfer(void) {
+    dmaStreamDisable(WS2812_DMA_STREAM);
+    dmaStreamSetMemory0(WS2812_DMA_STREAM, bit_buffer);
+    // Slots past this half's LEDs are never encoded, so the tail is zero-duty
+    dmaStreamSetTransactionSize(WS2812_DMA_STREAM, led_count * 24 + WS2812_TAIL_BITS);
+    dmaStreamSetMode(WS2812_DMA_STREAM, STM32_DMA_CR_CHSEL(WS2812_DMA_CHANNEL) | STM32_DMA_CR_DIR_M2P | STM32_DMA_CR_PSIZE_HWORD | STM32_DMA_CR_MSIZE_HWORD | STM32_DMA_CR_MINC | STM32_DMA_CR_PL(3));
+    dmaStreamEnable(WS2812_DMA_STREAM);
+}
+
+void ws2812_init(void) {
+#ifdef RGB_MATRIX_SPLIT
+    // rgb_matrix hands each half its own LEDs from index 0
+    const uint8_t split_count[2] = RGB_MATRIX_SPLIT;
+    led_count = split_count[is_keyboard_left() ? 0 : 1];
+#endif
+    palSetLineMode(WS2812_DI_PIN, PAL_MODE_ALTERNATE(WS2812_PWM_PAL_MODE) | PAL_OUTPUT_TYPE_PUSHPULL | PAL_OUTPUT_SPEED_HIGHEST);
+
+    static const PWMConfig pwm_config = {
+        .frequency = WS2812_PWM_FREQUENCY,
+        .period = WS2812_PWM_PERIOD,
+        .callback = NULL,
+        .channels = {
+            [0 ... 3] = {.mode = PWM_OUTPUT_DISABLED, .callback = NULL},
+            [WS2812_PWM_CHANNEL - 1] = {.mode = PWM_OUTPUT_ACTIVE_HIGH, .callback = NULL},
+        },
+        .cr2 = 0,
+        .dier = TIM_DIER_UDE,  // DMA request on each update: next bit's duty
+    };
+
+    dmaStreamAlloc(WS2812_DMA_STREAM - STM32_DMA_STREAM(0), 10, NULL, NULL);
+    dmaStreamSetPeripheral(WS2812_DMA_STREAM, &(WS2812_PWM_DRIVER.tim->CCR[WS2812_PWM_CHANNEL - 1]));
+
+    pwmStart(&WS2812_PWM_DRIVER, &pwm_config);
+    pwmEnableChannel(&WS2812_PWM_DRIVER, WS2812_PWM_CHANNEL - 1, 0);
+
+    // Send one all-off frame so the chain starts from a known state
+    encode_frame(256);
+    start_transfer();
+}
+
+void ws2812_set_color(int index, uint8_t red, uint8_t green, uint8_t blue) {
+    if (index < 0 || index >= WS2812_LED_COUNT) {
+        return;
+    }
+    leds[index].r = red;
+    leds[index].g = green;
+    leds[index].b = blue;
+}
+
+void ws2812_set_color_all(uint8_t red, uint8_t green, uint8_t blue) {
+    for (uint16_t i = 0; i < WS2812_LED_COUNT; i++) {
+        ws2812_set_color(i, red, green, blue);
+    }
+}
+
+// Effects and indicators rewrite every LED each frame; compare the end
+// result, not the writes, against what the LEDs already show
+void ws2812_flush(void) {
+    rgb_stats.flush_calls++;
+
+    uint8_t tier = yxa_power_tier();
+    bool dark = tier >= YXA_POWER_OFF && sent_tier >= YXA_POWER_OFF;
+    if (dark || (memcmp(leds, sent, sizeof(leds)) == 0 && tier == sent_tier)) {
+        rgb_stats.skipped_clean++;
+        return;
+    }
+    // Still clocking out the previous frame: the next flush picks this up
+    if (transfer_busy()) {
+        rgb_stats.skipped_busy++;
+        return;
+    }
+
+    memcpy(sent, leds, sizeof(leds));
+    sent_tier = tier;
+    encode_frame(frame_scale());
+    start_transfer();
+    rgb_stats.transfers++;
+}
+
+void yxa_rgb_stats_get(yxa_rgb_stats_t *stats) {
+    *stats = rgb_stats;
+}
+
+void yxa_rgb_stats_reset(void) {
+    uint16_t frame_ma = rgb_stats.frame_ma_last;
+    memset(&rgb_stats, 0, sizeof(rgb_stats));
+    rgb_stats.frame_ma_last = frame_ma;
+}
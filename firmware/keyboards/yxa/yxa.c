@@ -0,0 +1,114 @@
+// Copyright 2025 Yxa
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "quantum.h"
+#include "transactions.h"
+#include "yxa.h"
+
+// Slave side of YXA_SYNC_CHATTER: in = kind, out = YXA_CHATTER_KEYS values
+static void chatter_sync_slave_handler(uint8_t in_buflen, const void *in_data, uint8_t out_buflen, void *out_data) {
+    uint8_t kind = *(const uint8_t *)in_data;
+    if (kind == YXA_CHATTER_RESET) {
+        yxa_chatter_reset();
+        return;
+    }
+    yxa_chatter_read(kind, out_data);
+}
+
+bool yxa_chatter_request(bool left, uint8_t kind, uint8_t *out) {
+    if (left == is_keyboard_left()) {
+        if (kind == YXA_CHATTER_RESET) {
+            yxa_chatter_reset();
+        } else {
+            yxa_chatter_read(kind, out);
+        }
+        return true;
+    }
+    return transaction_rpc_exec(YXA_SYNC_CHATTER, sizeof(kind), &kind, YXA_CHATTER_KEYS, out);
+}
+
+// Indicator state: set by the master's keymap, pushed to the slave once per
+// change (and again when the link comes back, in case the slave rebooted).
+// [0] indicator byte, [1] overlay byte, [2] power tier.
+static uint8_t indicator_state[3] = {0};
+static bool indicator_dirty = false;
+
+static void indicator_put(uint8_t index, uint8_t value) {
+    if (value != indicator_state[index]) {
+        indicator_state[index] = value;
+        indicator_dirty = true;
+    }
+}
+
+void yxa_indicator_set(uint8_t state) {
+    indicator_put(0, state);
+}
+
+uint8_t yxa_indicator_get(void) {
+    return indicator_state[0];
+}
+
+void yxa_overlay_set(uint8_t overlay) {
+    indicator_put(1, overlay);
+}
+
+uint8_t yxa_overlay_get(void) {
+    return indicator_state[1];
+}
+
+void yxa_power_tier_set(uint8_t tier) {
+    indicator_put(2, tier);
+}
+
+uint8_t yxa_power_tier(void) {
+    return indicator_state[2];
+}
+
+static void indicator_sync_slave_handler(uint8_t in_buflen, const void *in_data, uint8_t out_buflen, void *out_data) {
+    memcpy(indicator_state, in_data, sizeof(indicator_state));
+}
+
+static void indicator_sync(void) {
+    static bool was_connected = false;
+    bool connected = split_sync_link_up();
+    if (connected && !was_connected) {
+        indicator_dirty = true;
+    }
+    was_connected = connected;
+
+    if (indicator_dirty && connected && transaction_rpc_send(YXA_SYNC_INDICATOR, sizeof(indicator_state), indicator_state)) {
+        indicator_dirty = false;
+    }
+}
+
+void housekeeping_task_kb(void) {
+    if (is_keyboard_master()) {
+        power_task();
+        indicator_sync();
+    }
+    tuning_task();
+    persist_task();
+    housekeeping_task_user();
+}
+
+// Key events carry when the change really happened, not when it got here
+bool pre_process_record_kb(uint16_t keycode, keyrecord_t *record) {
+    split_sync_stamp(record);
+    return pre_process_record_user(keycode, record);
+}
+
+void keyboard_post_init_kb(void) {
+    // Keep the core clock (and with it the DWT cycle counter) running in WFI
+    // sleep, so timings that span a blocking wait include the wait
+    DBGMCU->CR |= DBGMCU_CR_DBG_SLEEP;
+    transaction_register_rpc(YXA_SYNC_CHATTER, chatter_sync_slave_handler);
+    transaction_register_rpc(YXA_SYNC_INDICATOR, indicator_sync_slave_handler);
+    split_sync_init();
+    persist_init();
+    tuning_init();
+    yxa_chatter_persist_init();
+#ifdef YXA_SPLIT_DMA
+    serial_dma_init();
+#endif
+    keyboard_post_init_user();
+}
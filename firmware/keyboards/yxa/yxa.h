@@ -0,0 +1,215 @@
+// Copyright 2025 Yxa
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <hal.h>
+
+// Yxa is always split: rows 0-3 are the left half, 4-7 the right
+#ifndef ROWS_PER_HAND
+#    define ROWS_PER_HAND (MATRIX_ROWS / 2)
+#endif
+
+// DWT cycle counter for sub-millisecond timing (enabled by the STM32 HAL init,
+// kept counting through WFI sleep by keyboard_post_init_kb)
+#define YXA_CYCLES_PER_US (STM32_SYSCLK / 1000000U)
+
+static inline uint32_t yxa_cycles(void) {
+    return DWT->CYCCNT;
+}
+
+// Matrix scan statistics (this half only)
+typedef struct {
+    uint32_t scan_rate;         // Scans completed during the last full second
+    uint16_t read_cycles_avg;   // Port reads + key extraction, CPU cycles
+    uint16_t read_cycles_max;
+} yxa_scan_stats_t;
+
+void yxa_scan_stats_get(yxa_scan_stats_t *stats);
+void yxa_scan_stats_reset(void);
+
+// Eager-press debounce statistics: how much sooner presses were reported
+// than the global deferred algorithm would have reported them
+typedef struct {
+    uint32_t presses;
+    uint64_t saved_us_total;  // 32 bits would wrap after ~4300 s of savings
+    uint16_t saved_us_max;
+} yxa_debounce_stats_t;
+
+void yxa_debounce_set(uint8_t ms);
+void yxa_chatter_persist_init(void);
+void yxa_debounce_stats_get(yxa_debounce_stats_t *stats);
+void yxa_debounce_stats_reset(void);
+
+// Per-key chatter data for this half, row-major ROWS_PER_HAND x MATRIX_COLS
+#define YXA_CHATTER_KEYS (ROWS_PER_HAND * MATRIX_COLS)
+enum {
+    YXA_CHATTER_COUNTS = 0,  // Chatter events seen per key
+    YXA_CHATTER_DEBOUNCE,    // Current per-key release debounce (ms)
+    YXA_CHATTER_RESET,       // Clear counts and restore DEBOUNCE
+};
+
+void yxa_chatter_read(uint8_t kind, uint8_t *out);
+void yxa_chatter_reset(void);
+
+// Same for either half; the other half is fetched over the split link
+bool yxa_chatter_request(bool left, uint8_t kind, uint8_t *out);
+
+// Split link statistics (master)
+typedef struct {
+    uint16_t poll_rate;             // Transport polls during the last second
+    uint16_t transport_cycles_avg;  // CPU cycles blocked per poll
+    uint16_t transport_cycles_max;
+    uint32_t delta_events;          // Slave changes applied from the delta log
+    uint32_t full_refreshes;        // Times the full matrix had to be used
+    uint32_t failed_polls;          // Transport rounds that failed while connected
+    uint16_t link_losses;           // Heartbeat timeouts (link declared down)
+    uint16_t recovery_ms_last;      // Outage length of the last reconnect
+    uint16_t recovery_ms_max;
+} yxa_split_stats_t;
+
+void yxa_split_stats_get(yxa_split_stats_t *stats);
+void yxa_split_stats_reset(void);
+
+// WS2812 flush statistics (ws2812_dma.c, this half)
+typedef struct {
+    uint32_t flush_calls;    // Frames rgb_matrix asked to send
+    uint32_t transfers;      // DMA transfers started
+    uint32_t skipped_clean;  // Frame identical to the LEDs' current colors
+    uint32_t skipped_busy;   // Previous transfer still running, retried later
+    uint32_t scaled_frames;  // Frames dimmed to stay within the current limit
+    uint16_t frame_ma_last;  // Estimated draw of the last frame, before scaling
+    uint16_t frame_ma_max;
+} yxa_rgb_stats_t;
+
+void yxa_rgb_stats_get(yxa_rgb_stats_t *stats);
+void yxa_rgb_stats_reset(void);
+
+// Indicator state, one byte synced master -> slave on change (yxa.c):
+// bits 0-3 effective layer, bit 4 caps word, bits 5-7 render mode
+#define YXA_INDICATOR_LAYER_MASK 0x0F
+#define YXA_INDICATOR_CAPS_WORD 0x10
+#define YXA_INDICATOR_MODE_SHIFT 5
+#define YXA_INDICATOR_MODE_MASK 0xE0
+
+enum {
+    YXA_RENDER_LAYER = 0,  // Layer colors
+    YXA_RENDER_HEATMAP,    // Keypress heatmap on the BASE layer
+};
+
+void yxa_indicator_set(uint8_t state);
+uint8_t yxa_indicator_get(void);
+
+// Hold overlay, synced along with the indicator byte: bits 0-3 active mods
+// (Ctrl, Shift, Alt, GUI, either side), bits 4-7 pending layer-tap as slot
+// + 1 among the BASE layer's layer-tap keys in matrix order, 0 for none
+#define YXA_OVERLAY_MODS_MASK 0x0F
+#define YXA_OVERLAY_PENDING_SHIFT 4
+
+void yxa_overlay_set(uint8_t overlay);
+uint8_t yxa_overlay_get(void);
+
+// Idle power tiers (power.c), synced with the indicator state
+enum {
+    YXA_POWER_ACTIVE = 0,
+    YXA_POWER_DIM,   // LEDs dimmed
+    YXA_POWER_OFF,   // LEDs off, WS2812 DMA idle
+    YXA_POWER_SLOW,  // Also a slower idle scan cadence
+};
+
+void power_task(void);
+void yxa_power_tier_set(uint8_t tier);
+uint8_t yxa_power_tier(void);
+
+// Runtime tuning block (tuning.c): kept in the keyboard's EEPROM datablock,
+// applied live on both halves and synced master -> slave. Multi-byte
+// fields are little-endian, the layout is what the host reads and writes.
+#define YXA_TUNING_VERSION 1
+
+typedef struct __attribute__((packed)) {
+    uint8_t version;
+    uint8_t debounce;               // Base release debounce (ms)
+    uint16_t tapping_term;          // Other tap-hold keys (ms)
+    uint16_t tapping_term_mod_tap;  // Home-row mods
+    uint16_t tapping_term_layer;    // Layer-tap thumb keys
+    uint16_t quick_tap_term;
+    uint8_t rgb_brightness;         // Full layer color brightness
+    uint8_t mouse_profile;          // Base mouse-key profile
+    uint8_t mouse_speed;            // Cursor speed, % of the profile's
+    uint8_t wheel_speed;            // Wheel speed, % of the configured
+    uint8_t reserved[2];
+} yxa_tuning_t;
+
+_Static_assert(sizeof(yxa_tuning_t) == YXA_TUNING_SIZE, "Tuning block layout doesn't match its EEPROM space");
+
+void tuning_init(void);
+void tuning_task(void);
+const yxa_tuning_t *yxa_tuning(void);
+bool yxa_tuning_set(const yxa_tuning_t *tuning);
+void yxa_tuning_defaults(yxa_tuning_t *tuning);
+// Keymap's own range checks, on top of the keyboard's (default: accept)
+bool yxa_tuning_valid_user(const yxa_tuning_t *tuning);
+
+// Persistence service (persist.c): registered RAM records written back to
+// EEPROM in idle-time batches. Record ids tag the stored copy; keep 0 and
+// 0xFF unused (blank datablock).
+enum {
+    YXA_PERSIST_CHATTER_DEBOUNCE = 1,  // Learned per-key release debounce
+    YXA_PERSIST_CHATTER_COUNTS,
+    YXA_PERSIST_DEFAULT_LAYER,
+};
+
+// Each record's fixed slot in the persist area: the id tag, then the data.
+// Slots never move when a record is added, dropped or registered in another
+// order; a new record takes free space after the last one.
+#define YXA_PERSIST_CHATTER_COUNTS_OFFSET 0     // 1 + YXA_CHATTER_KEYS
+#define YXA_PERSIST_CHATTER_DEBOUNCE_OFFSET 21  // 1 + YXA_CHATTER_KEYS
+#define YXA_PERSIST_DEFAULT_LAYER_OFFSET 42     // 1 + 1
+
+_Static_assert(YXA_PERSIST_CHATTER_COUNTS_OFFSET + 1 + YXA_CHATTER_KEYS <= YXA_PERSIST_CHATTER_DEBOUNCE_OFFSET && YXA_PERSIST_CHATTER_DEBOUNCE_OFFSET + 1 + YXA_CHATTER_KEYS <= YXA_PERSIST_DEFAULT_LAYER_OFFSET && YXA_PERSIST_DEFAULT_LAYER_OFFSET + 2 <= YXA_PERSIST_SIZE, "Persist record slots overlap");
+
+typedef struct {
+    uint32_t flushes;         // Batches that wrote anything
+    uint32_t records_written;
+    uint32_t bytes_written;   // Bytes that differed from the stored copy
+    uint16_t flush_us_last;   // Main loop stall of the last batch
+    uint16_t flush_us_max;
+    uint8_t dirty_records;    // Waiting for the next batch
+    uint8_t bytes_used;       // Of YXA_PERSIST_SIZE, up to the last record
+} yxa_persist_stats_t;
+
+void persist_init(void);
+void persist_task(void);
+// Loads the stored copy at offset into data; false (data untouched) if
+// there is none
+bool yxa_persist_register(uint8_t id, uint8_t offset, void *data, uint8_t size);
+void yxa_persist_dirty(uint8_t id);
+bool yxa_persist_pending(uint8_t id);
+void yxa_persist_flush(void);
+void yxa_persist_stats_get(yxa_persist_stats_t *stats);
+void yxa_persist_stats_reset(void);
+
+// Split matrix exchange (split_sync.c), driven from matrix_scan()
+void split_sync_init(void);
+void split_sync_log(const matrix_row_t before[], const matrix_row_t after[]);
+bool split_sync_master(const matrix_row_t before[], const matrix_row_t after[], bool local_changed);
+void split_sync_slave(matrix_row_t master_rows[]);
+bool split_sync_link_up(void);
+void split_sync_stamp(keyrecord_t *record);
+
+#ifdef YXA_SPLIT_DMA
+// Full-duplex DMA split transport (serial_dma.c): round trip per link
+// transaction at each benchmarked rate (master)
+#    define YXA_SPLIT_BENCH_RATES 4
+typedef struct {
+    uint32_t speed;
+    uint16_t rtt_us_avg;
+    uint16_t rtt_us_max;
+    uint8_t errors;  // Failed transactions, 255 if the rate couldn't be set up
+} yxa_split_bench_t;
+
+void serial_dma_init(void);
+void yxa_split_bench(yxa_split_bench_t results[YXA_SPLIT_BENCH_RATES]);
+#endif